@@ -0,0 +1,208 @@
+#include <benchmark/benchmark.h>
+#include <sg14/flat_map.h>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template<size_t N>
+struct Blob {
+    Blob() = default;
+    explicit Blob(int i) { data_.fill(static_cast<unsigned char>(i)); }
+    int get() const { return data_[0]; }
+    std::array<unsigned char, N> data_ = {};
+};
+
+} // namespace
+
+static void Counts(benchmark::internal::Benchmark *b)
+{
+    b->RangeMultiplier(10)->Range(10, 10'000'000);
+}
+
+// The map contains the even keys [0, 2n); the odd keys are all absent.
+static std::vector<int> get_sorted_keys(size_t n)
+{
+    auto v = std::vector<int>(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = static_cast<int>(2 * i);
+    }
+    return v;
+}
+
+static std::vector<int> get_shuffled_keys(size_t n)
+{
+    auto v = get_sorted_keys(n);
+    std::shuffle(v.begin(), v.end(), std::mt19937());
+    return v;
+}
+
+template<class K, class V>
+static void fill_map(std::map<K, V>& m, size_t n)
+{
+    for (int k : get_sorted_keys(n)) {
+        m.emplace_hint(m.end(), k, V(k));
+    }
+}
+
+template<class K, class V>
+static void fill_map(sg14::flat_map<K, V>& m, size_t n)
+{
+    auto keys = get_sorted_keys(n);
+    auto values = std::vector<V>(keys.begin(), keys.end());
+    m.replace(sg14::sorted_unique, std::move(keys), std::move(values));
+}
+
+template<class K, class V>
+static void fill_map(sg14::interleaved_flat_map<K, V>& m, size_t n)
+{
+    auto keys = get_sorted_keys(n);
+    auto pairs = std::vector<std::pair<K, V>>();
+    pairs.reserve(n);
+    for (int k : keys) {
+        pairs.emplace_back(k, V(k));
+    }
+    m = sg14::interleaved_flat_map<K, V>(sg14::sorted_unique, pairs.begin(), pairs.end());
+}
+
+template<class Map>
+static void MapInsertErase(benchmark::State& state)
+{
+    using V = typename Map::mapped_type;
+    size_t n = state.range(0);
+    Map m;
+    fill_map(m, n);
+    auto keys = get_shuffled_keys(n);
+    size_t i = 0;
+    for (auto _ : state) {
+        int k = keys[i] + 1;
+        auto it = m.emplace(k, V(k)).first;
+        benchmark::DoNotOptimize(it);
+        m.erase(it);
+        i = (i + 1 == n) ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class Map>
+static void MapFindHit(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    Map m;
+    fill_map(m, n);
+    auto keys = get_shuffled_keys(n);
+    size_t i = 0;
+    for (auto _ : state) {
+        auto it = m.find(keys[i]);
+        benchmark::DoNotOptimize(it);
+        i = (i + 1 == n) ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class Map>
+static void MapFindMiss(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    Map m;
+    fill_map(m, n);
+    auto keys = get_shuffled_keys(n);
+    size_t i = 0;
+    for (auto _ : state) {
+        auto it = m.find(keys[i] + 1);
+        benchmark::DoNotOptimize(it);
+        i = (i + 1 == n) ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Resolves the keys in batches of 256, either with find in a loop or with one call to find_many.
+template<class Map, bool UseFindMany>
+static void MapFindBatch(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    Map m;
+    fill_map(m, n);
+    auto keys = get_shuffled_keys(n);
+    keys.resize(std::max<size_t>(n, 256));
+    auto its = std::vector<typename Map::iterator>(256);
+    size_t i = 0;
+    for (auto _ : state) {
+        auto first = keys.begin() + i;
+        if (UseFindMany) {
+            m.find_many(first, first + 256, its.begin());
+        } else {
+            for (size_t j = 0; j < 256; ++j) {
+                its[j] = m.find(first[j]);
+            }
+        }
+        benchmark::DoNotOptimize(its.data());
+        i = (i + 512 > keys.size()) ? 0 : i + 256;
+    }
+    state.SetItemsProcessed(state.iterations() * 256);
+}
+
+template<class Map>
+static void MapIterate(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    Map m;
+    fill_map(m, n);
+    for (auto _ : state) {
+        int sum = 0;
+        for (auto&& kv : m) {
+            sum += kv.first + kv.second.get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Building a flat_map one element at a time is quadratic, so stop at 100k.
+template<class Map>
+static void MapBuildShuffled(benchmark::State& state)
+{
+    using V = typename Map::mapped_type;
+    size_t n = state.range(0);
+    auto pairs = std::vector<std::pair<int, V>>();
+    for (int k : get_shuffled_keys(n)) {
+        pairs.emplace_back(k, V(k));
+    }
+    for (auto _ : state) {
+        Map m(pairs.begin(), pairs.end());
+        benchmark::DoNotOptimize(m);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(MapInsertErase, sg14::flat_map<int, Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapInsertErase, std::map<int, Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapInsertErase, sg14::flat_map<int, Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapInsertErase, std::map<int, Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(MapFindHit, sg14::flat_map<int, Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapFindHit, std::map<int, Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapFindHit, sg14::flat_map<int, Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapFindHit, std::map<int, Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapFindHit, sg14::flat_map<int, Blob<2>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapFindHit, sg14::interleaved_flat_map<int, Blob<2>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(MapFindMiss, sg14::flat_map<int, Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapFindMiss, std::map<int, Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapFindMiss, sg14::flat_map<int, Blob<2>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapFindMiss, sg14::interleaved_flat_map<int, Blob<2>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(MapFindBatch, sg14::flat_map<int, Blob<8>>, false)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapFindBatch, sg14::flat_map<int, Blob<8>>, true)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(MapIterate, sg14::flat_map<int, Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapIterate, std::map<int, Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapIterate, sg14::flat_map<int, Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(MapIterate, std::map<int, Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(MapBuildShuffled, sg14::flat_map<int, Blob<8>>)->RangeMultiplier(10)->Range(10, 100'000);
+BENCHMARK_TEMPLATE(MapBuildShuffled, std::map<int, Blob<8>>)->RangeMultiplier(10)->Range(10, 100'000);
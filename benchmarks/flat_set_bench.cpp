@@ -0,0 +1,173 @@
+#include <benchmark/benchmark.h>
+#include <sg14/eytzinger_flat_set.h>
+#include <sg14/flat_set.h>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+template<size_t N>
+struct Blob {
+    Blob() = default;
+    explicit Blob(int i) : key_(i) {}
+    friend bool operator<(const Blob& a, const Blob& b) { return a.key_ < b.key_; }
+    int get() const { return key_; }
+    int key_ = 0;
+    std::array<unsigned char, N - sizeof(int)> data_ = {};
+};
+
+} // namespace
+
+static void Counts(benchmark::internal::Benchmark *b)
+{
+    b->RangeMultiplier(10)->Range(10, 10'000'000);
+}
+
+// The set contains the even keys [0, 2n); the odd keys are all absent.
+static std::vector<int> get_sorted_keys(size_t n)
+{
+    auto v = std::vector<int>(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = static_cast<int>(2 * i);
+    }
+    return v;
+}
+
+static std::vector<int> get_shuffled_keys(size_t n)
+{
+    auto v = get_sorted_keys(n);
+    std::shuffle(v.begin(), v.end(), std::mt19937());
+    return v;
+}
+
+template<class T>
+static void fill_set(std::set<T>& s, size_t n)
+{
+    for (int k : get_sorted_keys(n)) {
+        s.emplace_hint(s.end(), k);
+    }
+}
+
+template<class T>
+static void fill_set(sg14::flat_set<T>& s, size_t n)
+{
+    auto keys = get_sorted_keys(n);
+    s.replace(sg14::sorted_unique, std::vector<T>(keys.begin(), keys.end()));
+}
+
+template<class T>
+static void fill_set(sg14::eytzinger_flat_set<T>& s, size_t n)
+{
+    auto keys = get_sorted_keys(n);
+    s.replace(sg14::sorted_unique, std::vector<T>(keys.begin(), keys.end()));
+}
+
+template<class Set>
+static void SetInsertErase(benchmark::State& state)
+{
+    using T = typename Set::value_type;
+    size_t n = state.range(0);
+    Set s;
+    fill_set(s, n);
+    auto keys = get_shuffled_keys(n);
+    size_t i = 0;
+    for (auto _ : state) {
+        auto it = s.insert(T(keys[i] + 1)).first;
+        benchmark::DoNotOptimize(it);
+        s.erase(it);
+        i = (i + 1 == n) ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class Set>
+static void SetFindHit(benchmark::State& state)
+{
+    using T = typename Set::value_type;
+    size_t n = state.range(0);
+    Set s;
+    fill_set(s, n);
+    auto keys = get_shuffled_keys(n);
+    size_t i = 0;
+    for (auto _ : state) {
+        auto it = s.find(T(keys[i]));
+        benchmark::DoNotOptimize(it);
+        i = (i + 1 == n) ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class Set>
+static void SetFindMiss(benchmark::State& state)
+{
+    using T = typename Set::value_type;
+    size_t n = state.range(0);
+    Set s;
+    fill_set(s, n);
+    auto keys = get_shuffled_keys(n);
+    size_t i = 0;
+    for (auto _ : state) {
+        auto it = s.find(T(keys[i] + 1));
+        benchmark::DoNotOptimize(it);
+        i = (i + 1 == n) ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class Set>
+static void SetIterate(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    Set s;
+    fill_set(s, n);
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto& t : s) {
+            sum += t.get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Building a flat_set from unsorted input sorts it once, so this can go all the way up.
+template<class Set>
+static void SetBuildShuffled(benchmark::State& state)
+{
+    using T = typename Set::value_type;
+    size_t n = state.range(0);
+    auto keys = get_shuffled_keys(n);
+    auto elts = std::vector<T>(keys.begin(), keys.end());
+    for (auto _ : state) {
+        Set s(elts.begin(), elts.end());
+        benchmark::DoNotOptimize(s);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(SetInsertErase, sg14::flat_set<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetInsertErase, std::set<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetInsertErase, sg14::flat_set<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetInsertErase, std::set<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SetFindHit, sg14::flat_set<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetFindHit, std::set<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetFindHit, sg14::eytzinger_flat_set<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetFindHit, sg14::flat_set<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetFindHit, std::set<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetFindHit, sg14::eytzinger_flat_set<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SetFindMiss, sg14::flat_set<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetFindMiss, std::set<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetFindMiss, sg14::eytzinger_flat_set<Blob<8>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SetIterate, sg14::flat_set<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetIterate, std::set<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetIterate, sg14::flat_set<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetIterate, std::set<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SetBuildShuffled, sg14::flat_set<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SetBuildShuffled, std::set<Blob<8>>)->Apply(Counts);
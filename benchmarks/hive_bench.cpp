@@ -0,0 +1,251 @@
+#include <benchmark/benchmark.h>
+#include <sg14/hive.h>
+#include <algorithm>
+#include <array>
+#include <list>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template<size_t N>
+struct Blob {
+    Blob() = default;
+    explicit Blob(int i) { data_.fill(static_cast<unsigned char>(i)); }
+    int get() const { return data_[0]; }
+    std::array<unsigned char, N> data_ = {};
+};
+
+} // namespace
+
+static void Counts(benchmark::internal::Benchmark *b)
+{
+    b->RangeMultiplier(10)->Range(10, 10'000'000);
+}
+
+template<class T> static void insert_one(sg14::hive<T>& c, T t) { c.insert(std::move(t)); }
+template<class T> static void insert_one(std::list<T>& c, T t) { c.push_back(std::move(t)); }
+template<class T> static void insert_one(std::vector<T>& c, T t) { c.push_back(std::move(t)); }
+
+template<class Ctr>
+static Ctr make_container(size_t n)
+{
+    using T = typename Ctr::value_type;
+    Ctr c;
+    for (size_t i = 0; i < n; ++i) {
+        insert_one(c, T(static_cast<int>(i)));
+    }
+    return c;
+}
+
+// Erase every element whose index is 1 mod 4, leaving scattered holes.
+static auto isHole = [](const auto& t) { return (t.get() & 3) == 1; };
+
+template<class T>
+static size_t erase_holes(sg14::hive<T>& c)
+{
+    return std::erase_if(c, isHole);
+}
+
+template<class T>
+static size_t erase_holes(std::list<T>& c)
+{
+    size_t oldsize = c.size();
+    c.remove_if(isHole);
+    return oldsize - c.size();
+}
+
+template<class T>
+static size_t erase_holes(std::vector<T>& c)
+{
+    size_t oldsize = c.size();
+    c.erase(std::remove_if(c.begin(), c.end(), isHole), c.end());
+    return oldsize - c.size();
+}
+
+template<class Ctr>
+static void HiveInsert(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        Ctr c = make_container<Ctr>(n);
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<class Ctr>
+static void HiveEraseIf(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Ctr c = make_container<Ctr>(n);
+        state.ResumeTiming();
+        auto count = erase_holes(c);
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<class Ctr>
+static void HiveIterate(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    Ctr c = make_container<Ctr>(n);
+    erase_holes(c);
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto& t : c) {
+            sum += t.get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * c.size());
+}
+
+// Visits the same elements as HiveIterate, either with a range-for loop or with
+// sg14::hive_for_each, which runs a plain loop over each fully packed group.
+template<class T, bool UseForEach, bool WithHoles>
+static void HiveForEach(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    auto c = make_container<sg14::hive<T>>(n);
+    if (WithHoles) {
+        erase_holes(c);
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        if (UseForEach) {
+            sg14::hive_for_each(c, [&](const T& t) { sum += t.get(); });
+        } else {
+            for (const auto& t : c) {
+                sum += t.get();
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * c.size());
+}
+
+// Erases every fourth element, either with std::erase_if or with
+// sg14::hive_parallel_erase_if on all available threads.
+template<class T, bool UseParallel>
+static void HiveParallelEraseIf(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto c = make_container<sg14::hive<T>>(n);
+        state.ResumeTiming();
+        size_t count = UseParallel ? sg14::hive_parallel_erase_if(c, isHole) : std::erase_if(c, isHole);
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Sorts a hive of pseudo-random keys with sort(), sort_in_place(), or radix_sort().
+template<int Mode>
+static void HiveSort(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        sg14::hive<unsigned> c;
+        unsigned x = 1;
+        for (size_t i = 0; i < n; ++i) {
+            x = x * 1664525u + 1013904223u;
+            c.insert(x);
+        }
+        state.ResumeTiming();
+        if (Mode == 0) {
+            c.sort();
+        } else if (Mode == 1) {
+            c.sort_in_place();
+        } else {
+            c.radix_sort([](unsigned k) { return k; });
+        }
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Creates and destroys many small hives, with or without a shared group pool.
+template<bool UsePool>
+static void HiveSpawn(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    sg14::hive_group_pool<int> pool;
+    for (auto _ : state) {
+        sg14::hive<int> h;
+        if (UsePool) {
+            h.set_group_pool(&pool);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            h.insert(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(h);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// A hive is usually chosen over a vector for the stability of its pointers;
+// re-filling the holes left by erase is the operation that a vector can't do cheaply.
+template<class Ctr>
+static void HiveRefill(benchmark::State& state)
+{
+    using T = typename Ctr::value_type;
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Ctr c = make_container<Ctr>(n);
+        auto count = erase_holes(c);
+        state.ResumeTiming();
+        for (size_t i = 0; i < count; ++i) {
+            insert_one(c, T(static_cast<int>(i)));
+        }
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * (n / 4));
+}
+
+BENCHMARK_TEMPLATE(HiveInsert, sg14::hive<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveInsert, std::list<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveInsert, std::vector<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveInsert, sg14::hive<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveInsert, std::list<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveInsert, std::vector<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(HiveEraseIf, sg14::hive<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveEraseIf, std::list<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveEraseIf, std::vector<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveEraseIf, sg14::hive<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveEraseIf, std::list<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveEraseIf, std::vector<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(HiveIterate, sg14::hive<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveIterate, std::list<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveIterate, std::vector<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveIterate, sg14::hive<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveIterate, std::list<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveIterate, std::vector<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(HiveRefill, sg14::hive<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveRefill, std::list<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveRefill, sg14::hive<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveRefill, std::list<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(HiveForEach, Blob<8>, false, false)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveForEach, Blob<8>, true, false)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveForEach, Blob<8>, false, true)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveForEach, Blob<8>, true, true)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(HiveParallelEraseIf, Blob<8>, false)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveParallelEraseIf, Blob<8>, true)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(HiveSort, 0)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveSort, 1)->Apply(Counts);
+BENCHMARK_TEMPLATE(HiveSort, 2)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(HiveSpawn, false)->Arg(4)->Arg(16)->Arg(100);
+BENCHMARK_TEMPLATE(HiveSpawn, true)->Arg(4)->Arg(16)->Arg(100);
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <sg14/inplace_function.h>
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace {
+
+// A callable whose captured state is N bytes.
+template<size_t N>
+struct Callable {
+    explicit Callable(int i) { data_.fill(static_cast<unsigned char>(i)); }
+    int operator()(int x) const { return x + data_[0]; }
+    std::array<unsigned char, N> data_;
+};
+
+} // namespace
+
+static void Counts(benchmark::internal::Benchmark *b)
+{
+    b->RangeMultiplier(10)->Range(10, 10'000'000);
+}
+
+template<class F, class C>
+static std::vector<F> make_functions(size_t n)
+{
+    auto v = std::vector<F>();
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        v.emplace_back(C(static_cast<int>(i)));
+    }
+    return v;
+}
+
+template<class F, class C>
+static void FunctionConstruct(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        auto v = make_functions<F, C>(n);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<class F, class C>
+static void FunctionCopy(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    auto v = make_functions<F, C>(n);
+    for (auto _ : state) {
+        auto v2 = v;
+        benchmark::DoNotOptimize(v2);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<class F, class C>
+static void FunctionInvoke(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    auto v = make_functions<F, C>(n);
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto& f : v) {
+            sum = f(sum);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+using InplaceF = sg14::inplace_function<int(int), 64>;
+using StdF = std::function<int(int)>;
+
+BENCHMARK_TEMPLATE(FunctionConstruct, InplaceF, Callable<8>)->Apply(Counts);
+BENCHMARK_TEMPLATE(FunctionConstruct, StdF, Callable<8>)->Apply(Counts);
+BENCHMARK_TEMPLATE(FunctionConstruct, InplaceF, Callable<48>)->Apply(Counts);
+BENCHMARK_TEMPLATE(FunctionConstruct, StdF, Callable<48>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(FunctionCopy, InplaceF, Callable<8>)->Apply(Counts);
+BENCHMARK_TEMPLATE(FunctionCopy, StdF, Callable<8>)->Apply(Counts);
+BENCHMARK_TEMPLATE(FunctionCopy, InplaceF, Callable<48>)->Apply(Counts);
+BENCHMARK_TEMPLATE(FunctionCopy, StdF, Callable<48>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(FunctionInvoke, InplaceF, Callable<8>)->Apply(Counts);
+BENCHMARK_TEMPLATE(FunctionInvoke, StdF, Callable<8>)->Apply(Counts);
+BENCHMARK_TEMPLATE(FunctionInvoke, InplaceF, Callable<48>)->Apply(Counts);
+BENCHMARK_TEMPLATE(FunctionInvoke, StdF, Callable<48>)->Apply(Counts);
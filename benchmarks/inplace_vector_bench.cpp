@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <sg14/inplace_vector.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace {
+
+template<size_t N>
+struct Blob {
+    Blob() = default;
+    explicit Blob(int i) { data_.fill(static_cast<unsigned char>(i)); }
+    int get() const { return data_[0]; }
+    std::array<unsigned char, N> data_ = {};
+};
+
+// The capacity of an inplace_vector is a template parameter, so each count
+// is its own instantiation. The vectors live on the heap (via unique_ptr)
+// so that the larger ones don't overflow the stack.
+template<class T, size_t N>
+struct InplaceVector {
+    using type = sg14::inplace_vector<T, N>;
+    static constexpr size_t count = N;
+    static auto make() { return std::make_unique<type>(); }
+};
+
+template<class T, size_t N>
+struct StdVector {
+    using type = std::vector<T>;
+    static constexpr size_t count = N;
+    static auto make() { auto p = std::make_unique<type>(); p->reserve(N); return p; }
+};
+
+} // namespace
+
+template<class V>
+static void VectorPushBack(benchmark::State& state)
+{
+    using T = typename V::type::value_type;
+    auto v = V::make();
+    for (auto _ : state) {
+        for (size_t i = 0; i < V::count; ++i) {
+            v->push_back(T(static_cast<int>(i)));
+        }
+        benchmark::DoNotOptimize(v->data());
+        v->clear();
+    }
+    state.SetItemsProcessed(state.iterations() * V::count);
+}
+
+template<class V>
+static void VectorInsertEraseMiddle(benchmark::State& state)
+{
+    using T = typename V::type::value_type;
+    auto v = V::make();
+    for (size_t i = 0; i + 1 < V::count; ++i) {
+        v->push_back(T(static_cast<int>(i)));
+    }
+    for (auto _ : state) {
+        auto it = v->insert(v->begin() + v->size() / 2, T(1));
+        benchmark::DoNotOptimize(it);
+        v->erase(it);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class V>
+static void VectorIterate(benchmark::State& state)
+{
+    using T = typename V::type::value_type;
+    auto v = V::make();
+    for (size_t i = 0; i < V::count; ++i) {
+        v->push_back(T(static_cast<int>(i)));
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto& t : *v) {
+            sum += t.get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * V::count);
+}
+
+#define SG14_VECTOR_BENCHMARKS(Fn, T) \
+    BENCHMARK_TEMPLATE(Fn, InplaceVector<T, 10>); \
+    BENCHMARK_TEMPLATE(Fn, StdVector<T, 10>); \
+    BENCHMARK_TEMPLATE(Fn, InplaceVector<T, 1'000>); \
+    BENCHMARK_TEMPLATE(Fn, StdVector<T, 1'000>); \
+    BENCHMARK_TEMPLATE(Fn, InplaceVector<T, 100'000>); \
+    BENCHMARK_TEMPLATE(Fn, StdVector<T, 100'000>)
+
+SG14_VECTOR_BENCHMARKS(VectorPushBack, Blob<8>);
+SG14_VECTOR_BENCHMARKS(VectorPushBack, Blob<128>);
+SG14_VECTOR_BENCHMARKS(VectorInsertEraseMiddle, Blob<8>);
+SG14_VECTOR_BENCHMARKS(VectorInsertEraseMiddle, Blob<128>);
+SG14_VECTOR_BENCHMARKS(VectorIterate, Blob<8>);
+SG14_VECTOR_BENCHMARKS(VectorIterate, Blob<128>);
+
+// At 10M elements, only the small element type fits comfortably in memory.
+BENCHMARK_TEMPLATE(VectorPushBack, InplaceVector<Blob<8>, 10'000'000>);
+BENCHMARK_TEMPLATE(VectorPushBack, StdVector<Blob<8>, 10'000'000>);
+BENCHMARK_TEMPLATE(VectorIterate, InplaceVector<Blob<8>, 10'000'000>);
+BENCHMARK_TEMPLATE(VectorIterate, StdVector<Blob<8>, 10'000'000>);
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include <sg14/ring_span.h>
+#include <array>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template<size_t N>
+struct Blob {
+    Blob() = default;
+    explicit Blob(int i) { data_.fill(static_cast<unsigned char>(i)); }
+    int get() const { return data_[0]; }
+    std::array<unsigned char, N> data_ = {};
+};
+
+// A bounded FIFO queue of capacity n, as it would be written with a std::deque.
+template<class T>
+struct DequeQueue {
+    using value_type = T;
+
+    explicit DequeQueue(size_t n) : capacity_(n) {}
+    void push_back(T t) {
+        if (q_.size() == capacity_) {
+            q_.pop_front();
+        }
+        q_.push_back(std::move(t));
+    }
+    T pop_front() { T t = std::move(q_.front()); q_.pop_front(); return t; }
+    auto begin() const { return q_.begin(); }
+    auto end() const { return q_.end(); }
+
+    std::deque<T> q_;
+    size_t capacity_;
+};
+
+// The same queue as a ring_span over a buffer that is allocated up front.
+template<class T>
+struct RingQueue {
+    using value_type = T;
+
+    explicit RingQueue(size_t n) : buffer_(n), r_(buffer_.begin(), buffer_.end()) {}
+    void push_back(T t) { r_.push_back(std::move(t)); }
+    T pop_front() { return r_.pop_front(); }
+    auto begin() const { return r_.begin(); }
+    auto end() const { return r_.end(); }
+
+    std::vector<T> buffer_;
+    sg14::ring_span<T> r_;
+};
+
+} // namespace
+
+static void Counts(benchmark::internal::Benchmark *b)
+{
+    b->RangeMultiplier(10)->Range(10, 10'000'000);
+}
+
+template<class Q>
+static void RingFill(benchmark::State& state)
+{
+    using T = typename Q::value_type;
+    size_t n = state.range(0);
+    Q q(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; ++i) {
+            q.push_back(T(static_cast<int>(i)));
+        }
+        benchmark::DoNotOptimize(q);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<class Q>
+static void RingPushPop(benchmark::State& state)
+{
+    using T = typename Q::value_type;
+    size_t n = state.range(0);
+    Q q(n);
+    for (size_t i = 0; i + 1 < n; ++i) {
+        q.push_back(T(static_cast<int>(i)));
+    }
+    for (auto _ : state) {
+        q.push_back(T(1));
+        auto t = q.pop_front();
+        benchmark::DoNotOptimize(t);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class Q>
+static void RingIterate(benchmark::State& state)
+{
+    using T = typename Q::value_type;
+    size_t n = state.range(0);
+    Q q(n);
+    // Overfill by half, so that the ring_span's contents wrap around.
+    for (size_t i = 0; i < n + n / 2; ++i) {
+        q.push_back(T(static_cast<int>(i)));
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto& t : q) {
+            sum += t.get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(RingFill, RingQueue<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(RingFill, DequeQueue<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(RingFill, RingQueue<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(RingFill, DequeQueue<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(RingPushPop, RingQueue<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(RingPushPop, DequeQueue<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(RingPushPop, RingQueue<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(RingPushPop, DequeQueue<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(RingIterate, RingQueue<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(RingIterate, DequeQueue<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(RingIterate, RingQueue<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(RingIterate, DequeQueue<Blob<128>>)->Apply(Counts);
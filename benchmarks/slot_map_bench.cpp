@@ -0,0 +1,358 @@
+#include <benchmark/benchmark.h>
+#include <sg14/slot_map.h>
+#include <sg14/chunked_vector.h>
+#include <sg14/concurrent_slot_map.h>
+#include <sg14/slot_map_soa.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template<size_t N>
+struct Blob {
+    Blob() = default;
+    explicit Blob(int i) { data_.fill(static_cast<unsigned char>(i)); }
+    int get() const { return data_[0]; }
+    std::array<unsigned char, N> data_ = {};
+};
+
+// The handle-to-object map that a slot_map usually replaces.
+template<class T>
+struct HandleMap {
+    using key_type = unsigned;
+    using mapped_type = T;
+
+    key_type insert(T t) {
+        map_.emplace(next_, std::move(t));
+        return next_++;
+    }
+    auto find(key_type k) { return map_.find(k); }
+    void erase(key_type k) { map_.erase(k); }
+    auto begin() { return map_.begin(); }
+    auto end() { return map_.end(); }
+    static const T& value_of(const std::pair<const unsigned, T>& kv) { return kv.second; }
+
+    std::unordered_map<unsigned, T> map_;
+    unsigned next_ = 0;
+};
+
+template<class T>
+struct SlotMap : sg14::slot_map<T> {
+    static const T& value_of(const T& t) { return t; }
+};
+
+template<class T>
+struct ChunkedSlotMap : sg14::slot_map<T, std::pair<unsigned, unsigned>, sg14::chunked_vector> {
+    static const T& value_of(const T& t) { return t; }
+};
+
+} // namespace
+
+static void Counts(benchmark::internal::Benchmark *b)
+{
+    b->RangeMultiplier(10)->Range(10, 10'000'000);
+}
+
+template<class Map>
+static std::vector<typename Map::key_type> fill_map(Map& m, size_t n)
+{
+    using T = typename Map::mapped_type;
+    auto keys = std::vector<typename Map::key_type>();
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys.push_back(m.insert(T(static_cast<int>(i))));
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937());
+    return keys;
+}
+
+template<class Map>
+static void SlotInsert(benchmark::State& state)
+{
+    using T = typename Map::mapped_type;
+    size_t n = state.range(0);
+    for (auto _ : state) {
+        Map m;
+        for (size_t i = 0; i < n; ++i) {
+            auto k = m.insert(T(static_cast<int>(i)));
+            benchmark::DoNotOptimize(k);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<class Map>
+static void SlotInsertErase(benchmark::State& state)
+{
+    using T = typename Map::mapped_type;
+    size_t n = state.range(0);
+    Map m;
+    fill_map(m, n);
+    for (auto _ : state) {
+        auto k = m.insert(T(1));
+        benchmark::DoNotOptimize(k);
+        m.erase(k);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<class Map>
+static void SlotFind(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    Map m;
+    auto keys = fill_map(m, n);
+    size_t i = 0;
+    for (auto _ : state) {
+        auto it = m.find(keys[i]);
+        benchmark::DoNotOptimize(it);
+        i = (i + 1 == n) ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Each frame despawns a random 1000 entities and spawns 1000 new ones,
+// either one at a time or with erase_keys and a batch insert.
+template<class T, bool UseBatch>
+static void SlotSpawnDespawn(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    SlotMap<T> m;
+    auto keys = fill_map(m, n);
+    auto spawned = std::vector<T>(1000, T(1));
+    auto g = std::mt19937();
+    for (auto _ : state) {
+        size_t k = std::min<size_t>(1000, n);
+        for (size_t i = 0; i < k; ++i) {
+            std::swap(keys[n - 1 - i], keys[g() % (n - i)]);
+        }
+        auto doomed = keys.end() - k;
+        if (UseBatch) {
+            m.erase_keys(doomed, keys.end());
+            keys.erase(doomed, keys.end());
+            m.insert(spawned.begin(), spawned.begin() + k, std::back_inserter(keys));
+        } else {
+            for (auto it = doomed; it != keys.end(); ++it) {
+                m.erase(*it);
+            }
+            keys.erase(doomed, keys.end());
+            for (size_t i = 0; i < k; ++i) {
+                keys.push_back(m.insert(spawned[i]));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * std::min<size_t>(1000, n));
+}
+
+// Each iteration erases a random entity and spawns a new one, after a spike
+// that left the slot table at four times the population.
+template<class T, sg14::slot_reuse_policy Policy>
+static void SlotReuse(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    SlotMap<T> m;
+    m.set_reuse_policy(Policy);
+    m.reserve_slots(4 * n);
+    auto keys = fill_map(m, 4 * n);
+    m.erase_keys(keys.begin() + n, keys.end());
+    keys.resize(n);
+    auto g = std::mt19937();
+    for (auto _ : state) {
+        auto& key = keys[g() % n];
+        m.erase(key);
+        key = m.insert(T(1));
+        benchmark::DoNotOptimize(m.find(key));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Resolves the keys in batches of 256, either with find in a loop or with one call to find_many,
+// and then reads the values.
+template<class T, bool UseFindMany>
+static void SlotFindBatch(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    SlotMap<T> m;
+    auto keys = fill_map(m, n);
+    while (keys.size() < 512) {
+        keys.insert(keys.end(), keys.begin(), keys.begin() + std::min<size_t>(n, 512 - keys.size()));
+    }
+    auto its = std::vector<typename SlotMap<T>::iterator>(256);
+    size_t i = 0;
+    for (auto _ : state) {
+        auto first = keys.begin() + i;
+        if (UseFindMany) {
+            m.find_many(first, first + 256, its.begin());
+        } else {
+            for (size_t j = 0; j < 256; ++j) {
+                its[j] = m.find(first[j]);
+            }
+        }
+        int sum = 0;
+        for (auto it : its) {
+            sum += it->get();
+        }
+        benchmark::DoNotOptimize(sum);
+        i = (i + 512 > keys.size()) ? 0 : i + 256;
+    }
+    state.SetItemsProcessed(state.iterations() * 256);
+}
+
+template<class Map>
+static void SlotIterate(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    Map m;
+    auto keys = fill_map(m, n);
+    // Erase a quarter of the elements, so that the map isn't pristine.
+    for (size_t i = 0; i < n / 4; ++i) {
+        m.erase(keys[i]);
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (auto&& elt : m) {
+            sum += Map::value_of(elt).get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * (n - n / 4));
+}
+
+// One writer thread keeps replacing values while state.range(0) reader threads
+// (this one and range-1 others) look them up, either through a concurrent_slot_map
+// or through a slot_map behind a mutex. Measures this reader's lookups.
+template<bool Concurrent>
+static void SlotReadWhileWriting(benchmark::State& state)
+{
+    using T = Blob<8>;
+    constexpr size_t n = 10'000;
+    sg14::concurrent_slot_map<T> cm;
+    sg14::slot_map<T> m;
+    std::mutex mtx;
+    auto keys = std::vector<sg14::slot_map<T>::key_type>();
+    for (size_t i = 0; i < n; ++i) {
+        keys.push_back(Concurrent ? cm.insert(T(1)) : m.insert(T(1)));
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937());
+
+    std::atomic<bool> done{false};
+    auto read_loop = [&](auto&& should_continue) {
+        auto reader = cm.make_reader();
+        int sum = 0;
+        for (size_t i = 0; should_continue(); i = (i + 1 == n) ? 0 : i + 1) {
+            if (Concurrent) {
+                reader.read(keys[i], [&](const T& t) { sum += t.get(); });
+            } else {
+                std::lock_guard<std::mutex> lk(mtx);
+                sum += m.find(keys[i])->get();
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    };
+    auto threads = std::vector<std::thread>();
+    threads.emplace_back([&]() {
+        for (size_t i = 0; !done.load(std::memory_order_relaxed); i = (i + 1 == n) ? 0 : i + 1) {
+            if (Concurrent) {
+                cm.replace(keys[i], T(int(i)));
+            } else {
+                std::lock_guard<std::mutex> lk(mtx);
+                *m.find(keys[i]) = T(int(i));
+            }
+        }
+    });
+    for (int t = 1; t < state.range(0); ++t) {
+        threads.emplace_back([&]() { read_loop([&]() { return !done.load(std::memory_order_relaxed); }); });
+    }
+    read_loop([&]() { return state.KeepRunning(); });
+    done.store(true);
+    for (auto&& t : threads) {
+        t.join();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Sums one 8-byte field of a 64-byte entity, stored either as a slot_map of
+// whole entities or as a slot_map_soa with the field in its own column.
+namespace {
+struct Position { float x, y; };
+struct Entity { Position pos; Blob<56> cold; };
+} // namespace
+
+template<bool UseSoa>
+static void SlotIterateOneField(benchmark::State& state)
+{
+    size_t n = state.range(0);
+    sg14::slot_map<Entity> aos;
+    sg14::slot_map_soa<std::pair<unsigned, unsigned>, Position, Blob<56>> soa;
+    for (size_t i = 0; i < n; ++i) {
+        float f = static_cast<float>(i);
+        if (UseSoa) {
+            soa.emplace(Position{f, f}, Blob<56>(1));
+        } else {
+            aos.insert(Entity{Position{f, f}, Blob<56>(1)});
+        }
+    }
+    for (auto _ : state) {
+        float sum = 0;
+        if (UseSoa) {
+            for (const Position& p : soa.column<Position>()) {
+                sum += p.x;
+            }
+        } else {
+            for (const Entity& e : aos) {
+                sum += e.pos.x;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(SlotInsert, SlotMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotInsert, ChunkedSlotMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotInsert, HandleMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotInsert, SlotMap<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotInsert, ChunkedSlotMap<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotInsert, HandleMap<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SlotInsertErase, SlotMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotInsertErase, HandleMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotInsertErase, SlotMap<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotInsertErase, HandleMap<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SlotFind, SlotMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotFind, ChunkedSlotMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotFind, HandleMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotFind, SlotMap<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotFind, ChunkedSlotMap<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotFind, HandleMap<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SlotReuse, Blob<8>, sg14::slot_reuse_policy::fifo)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotReuse, Blob<8>, sg14::slot_reuse_policy::lifo)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SlotFindBatch, Blob<8>, false)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotFindBatch, Blob<8>, true)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SlotIterate, SlotMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotIterate, ChunkedSlotMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotIterate, HandleMap<Blob<8>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotIterate, SlotMap<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotIterate, ChunkedSlotMap<Blob<128>>)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotIterate, HandleMap<Blob<128>>)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SlotSpawnDespawn, Blob<8>, false)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotSpawnDespawn, Blob<8>, true)->Apply(Counts);
+
+BENCHMARK_TEMPLATE(SlotReadWhileWriting, false)->Arg(1)->Arg(3)->UseRealTime();
+BENCHMARK_TEMPLATE(SlotReadWhileWriting, true)->Arg(1)->Arg(3)->UseRealTime();
+
+BENCHMARK_TEMPLATE(SlotIterateOneField, false)->Apply(Counts);
+BENCHMARK_TEMPLATE(SlotIterateOneField, true)->Apply(Counts);
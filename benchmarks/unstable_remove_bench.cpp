@@ -1,6 +1,9 @@
 
 #include <benchmark/benchmark.h>
 #include <sg14/algorithm_ext.h>
+#include <algorithm>
+#include <array>
+#include <functional>
 #include <random>
 #include <vector>
 
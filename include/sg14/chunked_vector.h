@@ -0,0 +1,339 @@
+/*
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#ifndef SG14_CHUNKED_VECTOR_THROW
+#include <stdexcept>
+#define SG14_CHUNKED_VECTOR_THROW(x) throw (x)
+#endif
+
+namespace sg14 {
+
+template<class T, class Allocator> class chunked_vector;
+
+namespace chunked_vector_detail {
+
+// Each chunk holds the largest power of two elements that fit in 16 KiB
+// (but at least one element), so that finding an element is a shift and a mask.
+constexpr size_t chunk_bytes = 16384;
+
+constexpr int log2_floor(size_t n) { return (n <= 1) ? 0 : 1 + log2_floor(n / 2); }
+
+template<class T>
+constexpr int chunk_shift() { return log2_floor(chunk_bytes / sizeof(T)); }
+
+template<class T, bool Const>
+class iterator {
+    template<class, bool> friend class iterator;
+    template<class, class> friend class sg14::chunked_vector;
+
+    static constexpr int shift = chunk_shift<T>();
+    static constexpr size_t mask = (size_t(1) << shift) - 1;
+
+    explicit iterator(T *const *chunks, size_t i) : chunks_(chunks), i_(i) {}
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    iterator() = default;
+    template<bool C = Const, class = std::enable_if_t<C>>
+    iterator(const iterator<T, false>& rhs) : chunks_(rhs.chunks_), i_(rhs.i_) {}
+
+    reference operator*() const { return chunks_[i_ >> shift][i_ & mask]; }
+    pointer operator->() const { return std::addressof(**this); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    iterator& operator++() { ++i_; return *this; }
+    iterator& operator--() { --i_; return *this; }
+    iterator operator++(int) { auto copy = *this; ++i_; return copy; }
+    iterator operator--(int) { auto copy = *this; --i_; return copy; }
+    iterator& operator+=(difference_type n) { i_ += n; return *this; }
+    iterator& operator-=(difference_type n) { i_ -= n; return *this; }
+
+    friend iterator operator+(iterator it, difference_type n) { it += n; return it; }
+    friend iterator operator+(difference_type n, iterator it) { it += n; return it; }
+    friend iterator operator-(iterator it, difference_type n) { it -= n; return it; }
+    friend difference_type operator-(const iterator& a, const iterator& b) { return difference_type(a.i_ - b.i_); }
+
+    friend bool operator==(const iterator& a, const iterator& b) { return a.i_ == b.i_; }
+    friend bool operator!=(const iterator& a, const iterator& b) { return a.i_ != b.i_; }
+    friend bool operator<(const iterator& a, const iterator& b) { return a.i_ < b.i_; }
+    friend bool operator<=(const iterator& a, const iterator& b) { return a.i_ <= b.i_; }
+    friend bool operator>(const iterator& a, const iterator& b) { return a.i_ > b.i_; }
+    friend bool operator>=(const iterator& a, const iterator& b) { return a.i_ >= b.i_; }
+
+private:
+    T *const *chunks_ = nullptr;
+    size_t i_ = 0;
+};
+
+template<class Alloc>
+inline void propagate(Alloc& dst, Alloc& src, std::true_type) { dst = static_cast<Alloc&&>(src); }
+
+template<class Alloc>
+inline void propagate(Alloc&, Alloc&, std::false_type) {}
+
+} // namespace chunked_vector_detail
+
+// A sequence container that stores its elements in fixed-size chunks of
+// chunk_size (a power of two) elements each. Growing it allocates a new chunk
+// and never moves the existing elements, so, unlike vector, emplace_back and
+// reserve never invalidate references to elements (though they may invalidate
+// iterators). It can be used as slot_map's Container.
+template<class T, class Allocator = std::allocator<T>>
+class chunked_vector {
+    using alloc_traits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same<typename alloc_traits::pointer, T*>::value, "chunked_vector requires an allocator whose pointer type is T*");
+
+    static constexpr int shift_ = chunked_vector_detail::chunk_shift<T>();
+    static constexpr size_t mask_ = (size_t(1) << shift_) - 1;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = chunked_vector_detail::iterator<T, false>;
+    using const_iterator = chunked_vector_detail::iterator<T, true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type chunk_size = size_type(1) << chunked_vector_detail::chunk_shift<T>();
+
+    chunked_vector() : chunked_vector(Allocator()) {}
+    explicit chunked_vector(const Allocator& a) noexcept : alloc_(a) {}
+
+    chunked_vector(std::initializer_list<T> il, const Allocator& a = Allocator()) : chunked_vector(a) {
+        this->append(il.begin(), il.end());
+    }
+
+    template<class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    chunked_vector(InputIterator first, InputIterator last, const Allocator& a = Allocator()) : chunked_vector(a) {
+        this->append(first, last);
+    }
+
+    chunked_vector(const chunked_vector& rhs) : chunked_vector(rhs, alloc_traits::select_on_container_copy_construction(rhs.alloc_)) {}
+
+    chunked_vector(const chunked_vector& rhs, const Allocator& a) : chunked_vector(a) {
+        this->append(rhs.begin(), rhs.end());
+    }
+
+    chunked_vector(chunked_vector&& rhs) noexcept :
+        chunks_(static_cast<std::vector<T*>&&>(rhs.chunks_)), size_(rhs.size_), alloc_(static_cast<Allocator&&>(rhs.alloc_))
+    {
+        rhs.chunks_.clear();
+        rhs.size_ = 0;
+    }
+
+    chunked_vector& operator=(const chunked_vector& rhs) {
+        if (this != &rhs) {
+            using Propagate = typename alloc_traits::propagate_on_container_copy_assignment;
+            if (Propagate::value && alloc_ != rhs.alloc_) {
+                this->deallocate_chunks();
+            }
+            Allocator a = rhs.alloc_;
+            chunked_vector_detail::propagate(alloc_, a, Propagate{});
+            this->clear();
+            this->append(rhs.begin(), rhs.end());
+        }
+        return *this;
+    }
+
+    chunked_vector& operator=(chunked_vector&& rhs)
+        noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)
+    {
+        if (this != &rhs) {
+            using Propagate = typename alloc_traits::propagate_on_container_move_assignment;
+            if (Propagate::value || alloc_ == rhs.alloc_) {
+                // Steal rhs's chunks.
+                this->deallocate_chunks();
+                chunked_vector_detail::propagate(alloc_, rhs.alloc_, Propagate{});
+                chunks_.swap(rhs.chunks_);
+                size_ = rhs.size_;
+                rhs.size_ = 0;
+            } else {
+                this->clear();
+                this->reserve(rhs.size_);
+                for (auto&& t : rhs) {
+                    this->emplace_back(static_cast<T&&>(t));
+                }
+                rhs.clear();
+            }
+        }
+        return *this;
+    }
+
+    ~chunked_vector() { this->deallocate_chunks(); }
+
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
+    iterator begin() noexcept { return iterator(chunks_.data(), 0); }
+    iterator end() noexcept { return iterator(chunks_.data(), size_); }
+    const_iterator begin() const noexcept { return const_iterator(chunks_.data(), 0); }
+    const_iterator end() const noexcept { return const_iterator(chunks_.data(), size_); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return (std::min)(size_type(alloc_traits::max_size(alloc_)), chunks_.max_size()) & ~mask_; }
+    size_type capacity() const noexcept { return chunks_.size() << shift_; }
+
+    // O(n / chunk_size) time. Allocates whole chunks; existing elements never move.
+    //
+    void reserve(size_type n) {
+        if (n > max_size()) {
+            SG14_CHUNKED_VECTOR_THROW(std::length_error("chunked_vector::reserve"));
+        }
+        chunks_.reserve((n + mask_) >> shift_);
+        while (capacity() < n) {
+            this->add_chunk();
+        }
+    }
+
+    // Frees the chunks that hold no elements.
+    //
+    void shrink_to_fit() {
+        size_type needed = (size_ + mask_) >> shift_;
+        while (chunks_.size() > needed) {
+            alloc_traits::deallocate(alloc_, chunks_.back(), chunk_size);
+            chunks_.pop_back();
+        }
+        chunks_.shrink_to_fit();
+    }
+
+    reference operator[](size_type i) { return chunks_[i >> shift_][i & mask_]; }
+    const_reference operator[](size_type i) const { return chunks_[i >> shift_][i & mask_]; }
+    reference at(size_type i) {
+        if (i >= size_) {
+            SG14_CHUNKED_VECTOR_THROW(std::out_of_range("chunked_vector::at"));
+        }
+        return (*this)[i];
+    }
+    const_reference at(size_type i) const {
+        if (i >= size_) {
+            SG14_CHUNKED_VECTOR_THROW(std::out_of_range("chunked_vector::at"));
+        }
+        return (*this)[i];
+    }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size_ - 1]; }
+    const_reference back() const { return (*this)[size_ - 1]; }
+
+    // O(1) time and space complexity. Allocates a new chunk if the last one is full.
+    //
+    template<class... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == capacity()) {
+            this->add_chunk();
+        }
+        T *p = chunks_[size_ >> shift_] + (size_ & mask_);
+        alloc_traits::construct(alloc_, p, static_cast<Args&&>(args)...);
+        size_ += 1;
+        return *p;
+    }
+    void push_back(const T& t) { this->emplace_back(t); }
+    void push_back(T&& t) { this->emplace_back(static_cast<T&&>(t)); }
+
+    // O(1) time and space complexity. Keeps the emptied chunk for reuse.
+    //
+    void pop_back() {
+        size_ -= 1;
+        alloc_traits::destroy(alloc_, std::addressof((*this)[size_]));
+    }
+
+    void clear() noexcept {
+        while (size_ != 0) {
+            this->pop_back();
+        }
+    }
+
+    void swap(chunked_vector& rhs) noexcept {
+        using std::swap;
+        swap(chunks_, rhs.chunks_);
+        swap(size_, rhs.size_);
+        if (alloc_traits::propagate_on_container_swap::value) {
+            swap(alloc_, rhs.alloc_);
+        }
+    }
+
+    friend void swap(chunked_vector& lhs, chunked_vector& rhs) noexcept { lhs.swap(rhs); }
+
+private:
+    void add_chunk() {
+        // Grow the table first, so that the push_back can't throw and leak the chunk.
+        if (chunks_.size() == chunks_.capacity()) {
+            chunks_.reserve(2 * chunks_.size() + 1);
+        }
+        chunks_.push_back(alloc_traits::allocate(alloc_, chunk_size));
+    }
+
+    void deallocate_chunks() noexcept {
+        this->clear();
+        for (T *chunk : chunks_) {
+            alloc_traits::deallocate(alloc_, chunk, chunk_size);
+        }
+        chunks_.clear();
+    }
+
+    template<class InputIterator>
+    void append(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) {
+            this->emplace_back(*first);
+        }
+    }
+
+    std::vector<T*> chunks_;
+    size_type size_ = 0;
+    Allocator alloc_;
+};
+
+} // namespace sg14
@@ -0,0 +1,411 @@
+/*
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <sg14/slot_map.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sg14 {
+
+namespace concurrent_slot_map_detail {
+
+inline int log2_floor(uint64_t n)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(n);
+#else
+    int result = 0;
+    while (n >>= 1) {
+        ++result;
+    }
+    return result;
+#endif
+}
+
+// A table of atomic pointers that the writer can grow while readers index it.
+// Chunk k holds (64 << k) entries and is never moved or freed until the table is
+// destroyed, so growth doesn't invalidate the entries that readers may be looking at.
+template<class P>
+class atomic_table {
+    static constexpr int first_shift = 6;
+    static constexpr int max_chunks = 64 - first_shift;
+    using entry = std::atomic<P*>;
+
+    static size_t chunk_length(int k) { return size_t(1) << (first_shift + k); }
+
+public:
+    atomic_table() = default;
+    atomic_table(const atomic_table&) = delete;
+    atomic_table& operator=(const atomic_table&) = delete;
+    ~atomic_table() {
+        for (auto& chunk : chunks_) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Wait-free; returns nullptr for an index that has never been published.
+    // The entries are loaded and stored seq_cst, so that they are ordered with
+    // the readers' epochs (see concurrent_slot_map::reclaim).
+    P *load(size_t i) const {
+        if (i >= size_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return this->at(i).load(std::memory_order_seq_cst);
+    }
+
+    // Writer only.
+    void store(size_t i, P *p) { this->at(i).store(p, std::memory_order_seq_cst); }
+
+    // Writer only. Makes the entries [0, n) exist; new entries are null.
+    void grow_to(size_t n) {
+        while (capacity_ < n) {
+            int k = chunk_count_;
+            entry *chunk = new entry[chunk_length(k)];
+            for (size_t i = 0; i < chunk_length(k); ++i) {
+                chunk[i].store(nullptr, std::memory_order_relaxed);
+            }
+            chunks_[k].store(chunk, std::memory_order_release);
+            chunk_count_ += 1;
+            capacity_ += chunk_length(k);
+        }
+        if (size_.load(std::memory_order_relaxed) < n) {
+            size_.store(n, std::memory_order_release);
+        }
+    }
+
+private:
+    entry& at(size_t i) const {
+        size_t j = i + chunk_length(0);
+        int k = log2_floor(j) - first_shift;
+        return chunks_[k].load(std::memory_order_acquire)[j - chunk_length(k)];
+    }
+
+    std::atomic<entry*> chunks_[max_chunks] = {};
+    std::atomic<size_t> size_{0};
+    size_t capacity_ = 0;
+    int chunk_count_ = 0;
+};
+
+// Each reader owns one of these. epoch is 0 when the reader is not pinned.
+// The padding keeps two readers' epochs off the same cache line.
+struct reader_record {
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<bool> in_use{false};
+    char padding[64];
+};
+
+} // namespace concurrent_slot_map_detail
+
+// concurrent_slot_map is a slot_map that one writer thread may modify while any number
+// of reader threads look up values by key. Readers never block and never wait for the
+// writer: a lookup is a bounded number of atomic loads.
+//
+// Each value lives in an immutable node. The writer-side bookkeeping (free list,
+// generations, the dense array of values and its reverse map) is an ordinary
+// slot_map of node pointers; readers instead go through a table of atomic node
+// pointers indexed by the key's slot index, which grows without moving.
+// replace() publishes a new node for an existing key, so a concurrent reader
+// sees either the old value or the new one, never a mixture.
+// Erased and replaced nodes are freed by epoch-based reclamation, once no
+// pinned reader can still be looking at them.
+//
+// All member functions other than make_reader() are for the writer thread only.
+// Each reader thread calls make_reader() once and looks values up through the
+// returned reader.
+template<class T, class Key = std::pair<unsigned, unsigned>>
+class concurrent_slot_map {
+    using key_traits = slot_map_key_traits<Key>;
+    struct node {
+        template<class... Args>
+        explicit node(Args&&... args) : value(static_cast<Args&&>(args)...) {}
+        Key key;
+        T value;
+    };
+    using record = concurrent_slot_map_detail::reader_record;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using key_index_type = typename slot_map<node*, Key>::key_index_type;
+    using key_generation_type = typename slot_map<node*, Key>::key_generation_type;
+    using size_type = typename slot_map<node*, Key>::size_type;
+
+    class reader;
+
+    // A reader's pinned section. Pointers returned by find() remain valid
+    // until the read_guard is destroyed, even if the writer erases or
+    // replaces their values in the meantime.
+    class read_guard {
+        friend class reader;
+        explicit read_guard(const reader *r) : reader_(r) { reader_->enter(); }
+    public:
+        read_guard(read_guard&& rhs) noexcept : reader_(rhs.reader_) { rhs.reader_ = nullptr; }
+        read_guard& operator=(const read_guard&) = delete;
+        ~read_guard() {
+            if (reader_ != nullptr) {
+                reader_->leave();
+            }
+        }
+
+        // Wait-free.
+        //
+        const T *find(const key_type& key) const {
+            node *n = reader_->map_->published_.load(key_traits::get_index(key));
+            if (n != nullptr && key_traits::get_generation(n->key) == key_traits::get_generation(key)) {
+                return &n->value;
+            }
+            return nullptr;
+        }
+        bool contains(const key_type& key) const { return this->find(key) != nullptr; }
+
+    private:
+        const reader *reader_;
+    };
+
+    // A reader thread's handle on the map. A reader must not outlive the map,
+    // and must be used by only one thread at a time.
+    class reader {
+        friend class concurrent_slot_map;
+        explicit reader(const concurrent_slot_map *m, record *r) : map_(m), record_(r) {}
+    public:
+        reader(reader&& rhs) noexcept : map_(rhs.map_), record_(rhs.record_), depth_(rhs.depth_) {
+            rhs.record_ = nullptr;
+        }
+        reader(const reader&) = delete;
+        reader& operator=(const reader&) = delete;
+        ~reader() {
+            if (record_ != nullptr) {
+                record_->in_use.store(false, std::memory_order_release);
+            }
+        }
+
+        read_guard pin() const { return read_guard(this); }
+
+        // Calls f(value) if the key is present, and returns whether it was.
+        // Wait-free, apart from f itself.
+        //
+        template<class F>
+        bool read(const key_type& key, F&& f) const {
+            read_guard guard = this->pin();
+            const T *p = guard.find(key);
+            if (p == nullptr) {
+                return false;
+            }
+            static_cast<F&&>(f)(*p);
+            return true;
+        }
+
+    private:
+        friend class read_guard;
+
+        void enter() const {
+            if (depth_++ == 0) {
+                uint64_t e = map_->epoch_.load(std::memory_order_acquire);
+                record_->epoch.store(e, std::memory_order_seq_cst);
+            }
+        }
+        void leave() const {
+            if (--depth_ == 0) {
+                record_->epoch.store(0, std::memory_order_release);
+            }
+        }
+
+        const concurrent_slot_map *map_;
+        record *record_;
+        mutable unsigned depth_ = 0;
+    };
+
+    explicit concurrent_slot_map(size_type max_readers = 64) :
+        records_(new record[max_readers]), max_readers_(max_readers) {}
+
+    concurrent_slot_map(const concurrent_slot_map&) = delete;
+    concurrent_slot_map& operator=(const concurrent_slot_map&) = delete;
+
+    // No reader may be pinned when the map is destroyed.
+    ~concurrent_slot_map() {
+        for (node *n : writer_map_) {
+            delete n;
+        }
+        for (auto&& r : retired_) {
+            delete r.first;
+        }
+    }
+
+    // Lock-free; throws std::length_error if max_readers readers already exist.
+    //
+    reader make_reader() const {
+        for (size_type i = 0; i < max_readers_; ++i) {
+            bool expected = false;
+            if (!records_[i].in_use.load(std::memory_order_relaxed) &&
+                records_[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return reader(this, &records_[i]);
+            }
+        }
+        SLOT_MAP_THROW_EXCEPTION(std::length_error, "concurrent_slot_map::make_reader");
+    }
+
+    size_type size() const { return writer_map_.size(); }
+    bool empty() const { return writer_map_.empty(); }
+
+    // O(1) time and space complexity, amortized.
+    //
+    template<class... Args>
+    key_type emplace(Args&&... args) {
+        std::unique_ptr<node> n(new node(static_cast<Args&&>(args)...));
+        published_.grow_to(writer_map_.slot_count() + 1);
+        key_type key = writer_map_.emplace(n.get());
+        n->key = key;
+        published_.store(key_traits::get_index(key), n.release());
+        return key;
+    }
+    key_type insert(const mapped_type& value) { return this->emplace(value); }
+    key_type insert(mapped_type&& value) { return this->emplace(static_cast<mapped_type&&>(value)); }
+
+    // Publishes a new value for an existing key. A reader sees either the old
+    // value or the new one. Returns false (and does nothing) if the key is stale.
+    //
+    template<class... Args>
+    bool replace(const key_type& key, Args&&... args) {
+        auto it = writer_map_.find(key);
+        if (it == writer_map_.end()) {
+            return false;
+        }
+        std::unique_ptr<node> n(new node(static_cast<Args&&>(args)...));
+        n->key = (*it)->key;
+        this->reserve_retired();
+        node *old = *it;
+        *it = n.get();
+        published_.store(key_traits::get_index(key), n.release());
+        this->retire(old);
+        return true;
+    }
+
+    // O(1) time and space complexity, amortized.
+    //
+    size_type erase(const key_type& key) {
+        auto it = writer_map_.find(key);
+        if (it == writer_map_.end()) {
+            return 0;
+        }
+        this->reserve_retired();
+        node *old = *it;
+        published_.store(key_traits::get_index(key), nullptr);
+        writer_map_.erase(it);
+        this->retire(old);
+        return 1;
+    }
+
+    // Unlike slot_map::clear, this keeps the generation counters,
+    // so that readers holding old keys won't find the new values.
+    //
+    void clear() {
+        std::vector<key_type> keys;
+        keys.reserve(writer_map_.size());
+        for (node *n : writer_map_) {
+            keys.push_back(n->key);
+        }
+        for (const key_type& key : keys) {
+            this->erase(key);
+        }
+    }
+
+    // The writer may look at the values without pinning, since only
+    // the writer frees them.
+    //
+    const T *find(const key_type& key) const {
+        auto it = writer_map_.find(key);
+        return (it == writer_map_.end()) ? nullptr : &(*it)->value;
+    }
+    bool contains(const key_type& key) const { return this->find(key) != nullptr; }
+
+    template<class F>
+    void for_each(F&& f) const {
+        for (const node *n : writer_map_) {
+            f(n->key, static_cast<const T&>(n->value));
+        }
+    }
+
+    // Frees the erased and replaced values that no reader can still see.
+    // erase() and replace() call this periodically; the writer may also call it
+    // when it knows that the readers are idle.
+    //
+    void reclaim() {
+        // The unlinking of a node, a reader's storing of its epoch, its loading
+        // of a node, and this loading of its epoch are all seq_cst. So either
+        // we see the reader's epoch here, or the reader can't see the node.
+        uint64_t oldest = UINT64_MAX;
+        for (size_type i = 0; i < max_readers_; ++i) {
+            uint64_t e = records_[i].epoch.load(std::memory_order_seq_cst);
+            if (e != 0) {
+                oldest = (std::min)(oldest, e);
+            }
+        }
+        // A reader pinned at epoch e may hold nodes retired at epoch e or later.
+        auto mid = std::partition(retired_.begin(), retired_.end(), [&](const std::pair<node*, uint64_t>& r) {
+            return r.second >= oldest;
+        });
+        for (auto it = mid; it != retired_.end(); ++it) {
+            delete it->first;
+        }
+        retired_.erase(mid, retired_.end());
+        epoch_.fetch_add(1, std::memory_order_release);
+        reclaim_threshold_ = (std::max)(size_t(64), 2 * retired_.size());
+    }
+
+private:
+    // Makes sure that retire() can't throw after a node has been unlinked.
+    void reserve_retired() {
+        if (retired_.size() == retired_.capacity()) {
+            retired_.reserve(2 * retired_.size() + 1);
+        }
+    }
+
+    void retire(node *n) {
+        retired_.emplace_back(n, epoch_.load(std::memory_order_relaxed));
+        if (retired_.size() >= reclaim_threshold_) {
+            this->reclaim();
+        }
+    }
+
+    std::unique_ptr<record[]> records_;
+    size_type max_readers_;
+    std::atomic<uint64_t> epoch_{1};
+    concurrent_slot_map_detail::atomic_table<node> published_;
+    slot_map<node*, Key> writer_map_;
+    std::vector<std::pair<node*, uint64_t>> retired_;
+    size_t reclaim_threshold_ = 64;
+};
+
+} // namespace sg14
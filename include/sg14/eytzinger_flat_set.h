@@ -0,0 +1,382 @@
+/*
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+// This is a read-mostly variant of "sg14::flat_set" that stores its keys in
+// Eytzinger (breadth-first) order instead of sorted order: element 0 is the
+// root of an implicit binary search tree, and the children of the element at
+// index i-1 are at indices 2i-1 and 2i. A search touches the elements at the
+// top of the tree over and over, so those stay in cache; and the next four
+// levels of the search path sit in sixteen adjacent elements, so they can be
+// prefetched long before the comparisons reach them.
+//
+// The price is that iteration order is layout order, not sorted order,
+// and there is no insert or erase: build the whole set at once, via the
+// constructors or replace(), and use extract() to get the sorted keys back.
+
+#include <stddef.h>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace sg14 {
+
+namespace eytzinger_detail {
+    template<class It>
+    using is_random_access_iterator = std::is_convertible<
+        typename std::iterator_traits<It>::iterator_category,
+        std::random_access_iterator_tag
+    >;
+
+    inline void prefetch(const void *p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+        (void)p;
+#endif
+    }
+
+    // Returns the number of trailing one-bits in k.
+    inline int countr_one(size_t k) {
+#if defined(__GNUC__) || defined(__clang__)
+        return (~k == 0) ? int(sizeof(size_t) * 8) : __builtin_ctzll(static_cast<unsigned long long>(~k));
+#else
+        int n = 0;
+        while (k & 1) {
+            k >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    // Sets rank[k-1] to the in-order position of the 1-based node k
+    // in the implicit tree of rank.size() nodes.
+    inline void compute_ranks(std::vector<size_t>& rank, size_t& next, size_t k) {
+        if (k <= rank.size()) {
+            eytzinger_detail::compute_ranks(rank, next, 2*k);
+            rank[k-1] = next++;
+            eytzinger_detail::compute_ranks(rank, next, 2*k + 1);
+        }
+    }
+
+    // Rearranges c so that the element formerly at c[from[i]] ends up at c[i].
+    // Consumes from, which must be a permutation of [0, c.size()).
+    template<class Container>
+    void apply_permutation(Container& c, std::vector<size_t>& from) {
+        auto first = c.begin();
+        for (size_t i = 0; i < from.size(); ++i) {
+            if (from[i] == i) {
+                continue;
+            }
+            auto t = std::move(first[i]);
+            size_t j = i;
+            while (from[j] != i) {
+                size_t k = from[j];
+                first[j] = std::move(first[k]);
+                from[j] = j;
+                j = k;
+            }
+            first[j] = std::move(t);
+            from[j] = j;
+        }
+    }
+
+    template<class Container>
+    void sorted_to_eytzinger(Container& c) {
+        std::vector<size_t> rank(c.size());
+        size_t next = 0;
+        eytzinger_detail::compute_ranks(rank, next, 1);
+        eytzinger_detail::apply_permutation(c, rank);
+    }
+
+    template<class Container>
+    void eytzinger_to_sorted(Container& c) {
+        std::vector<size_t> rank(c.size());
+        size_t next = 0;
+        eytzinger_detail::compute_ranks(rank, next, 1);
+        std::vector<size_t> from(c.size());
+        for (size_t i = 0; i < rank.size(); ++i) {
+            from[rank[i]] = i;
+        }
+        eytzinger_detail::apply_permutation(c, from);
+    }
+
+    template<class It, class Compare>
+    It unique_helper(It first, It last, const Compare& compare) {
+        It dfirst = first;
+        while (first != last) {
+            It next = first;
+            ++next;
+            if ((next != last) && !bool(compare(*first, *next))) {
+                // "next" is a duplicate of "first", so do not preserve "first"
+            } else {
+                // do preserve "first"
+                if (first != dfirst) {
+                    *dfirst = std::move(*first);
+                }
+                ++dfirst;
+            }
+            first = next;
+        }
+        return dfirst;
+    }
+} // namespace eytzinger_detail
+
+#ifndef SG14_HAS_SORTED_UNIQUE
+#define SG14_HAS_SORTED_UNIQUE
+
+struct sorted_unique_t { explicit sorted_unique_t() = default; };
+
+#if defined(__cpp_inline_variables)
+inline
+#endif
+constexpr sorted_unique_t sorted_unique {};
+
+#endif // SG14_HAS_SORTED_UNIQUE
+
+template<
+    class Key,
+    class Compare = std::less<Key>,
+    class KeyContainer = std::vector<Key>
+>
+class eytzinger_flat_set {
+    static_assert(eytzinger_detail::is_random_access_iterator<typename KeyContainer::iterator>::value, "");
+    static_assert(std::is_same<Key, typename KeyContainer::value_type>::value, "");
+    static_assert(std::is_convertible<decltype(std::declval<const Compare&>()(std::declval<const Key&>(), std::declval<const Key&>())), bool>::value, "");
+public:
+    using key_type = Key;
+    using key_compare = Compare;
+    using value_type = Key;
+    using value_compare = Compare;
+    using reference = const Key&;
+    using const_reference = const Key&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using iterator = typename KeyContainer::const_iterator;
+    using const_iterator = typename KeyContainer::const_iterator;
+    using container_type = KeyContainer;
+
+    eytzinger_flat_set() = default;
+
+    explicit eytzinger_flat_set(KeyContainer ctr, const Compare& comp = Compare())
+        : c_(static_cast<KeyContainer&&>(ctr)), compare_(comp)
+    {
+        this->sort_and_unique_impl();
+        eytzinger_detail::sorted_to_eytzinger(c_);
+    }
+
+    eytzinger_flat_set(sorted_unique_t, KeyContainer ctr, const Compare& comp = Compare())
+        : c_(static_cast<KeyContainer&&>(ctr)), compare_(comp)
+    {
+        eytzinger_detail::sorted_to_eytzinger(c_);
+    }
+
+    explicit eytzinger_flat_set(const Compare& comp)
+        : compare_(comp) {}
+
+    template<class InputIterator>
+    eytzinger_flat_set(InputIterator first, InputIterator last, const Compare& comp = Compare())
+        : c_(first, last), compare_(comp)
+    {
+        this->sort_and_unique_impl();
+        eytzinger_detail::sorted_to_eytzinger(c_);
+    }
+
+    template<class InputIterator>
+    eytzinger_flat_set(sorted_unique_t, InputIterator first, InputIterator last, const Compare& comp = Compare())
+        : c_(first, last), compare_(comp)
+    {
+        eytzinger_detail::sorted_to_eytzinger(c_);
+    }
+
+    eytzinger_flat_set(std::initializer_list<Key> il, const Compare& comp = Compare())
+        : c_(il), compare_(comp)
+    {
+        this->sort_and_unique_impl();
+        eytzinger_detail::sorted_to_eytzinger(c_);
+    }
+
+    eytzinger_flat_set& operator=(std::initializer_list<Key> il) {
+        this->replace(KeyContainer(il));
+        return *this;
+    }
+
+    // Iteration visits the elements in layout order, not in sorted order.
+    const_iterator begin() const noexcept { return c_.begin(); }
+    const_iterator end() const noexcept { return c_.end(); }
+    const_iterator cbegin() const noexcept { return c_.begin(); }
+    const_iterator cend() const noexcept { return c_.end(); }
+
+#if __cplusplus >= 201703L
+    [[nodiscard]]
+#endif
+    bool empty() const noexcept { return c_.empty(); }
+    size_type size() const noexcept { return c_.size(); }
+    size_type max_size() const noexcept { return c_.max_size(); }
+
+    // Returns the keys in sorted order. O(n) time; O(n) extra space.
+    KeyContainer extract() && {
+        eytzinger_detail::eytzinger_to_sorted(c_);
+        KeyContainer result = static_cast<KeyContainer&&>(c_);
+        clear();
+        return result;
+    }
+
+    void replace(KeyContainer ctr) {
+        c_ = static_cast<KeyContainer&&>(ctr);
+        this->sort_and_unique_impl();
+        eytzinger_detail::sorted_to_eytzinger(c_);
+    }
+
+    void replace(sorted_unique_t, KeyContainer ctr) {
+        c_ = static_cast<KeyContainer&&>(ctr);
+        eytzinger_detail::sorted_to_eytzinger(c_);
+    }
+
+    void swap(eytzinger_flat_set& m) noexcept
+#if defined(__cpp_lib_is_swappable)
+        (std::is_nothrow_swappable<KeyContainer>::value && std::is_nothrow_swappable<Compare>::value)
+#endif
+    {
+        using std::swap;
+        swap(compare_, m.compare_);
+        swap(c_, m.c_);
+    }
+
+    friend void swap(eytzinger_flat_set& a, eytzinger_flat_set& b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    void clear() noexcept {
+        c_.clear();
+    }
+
+    Compare key_comp() const { return compare_; }
+    Compare value_comp() const { return compare_; }
+
+    // Returns the keys in layout order.
+    const KeyContainer& keys() const {
+        return c_;
+    }
+
+    const_iterator find(const Key& t) const {
+        auto it = this->lower_bound(t);
+        if (it == this->end() || compare_(t, *it)) {
+            return this->end();
+        }
+        return it;
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    const_iterator find(const K& x) const {
+        auto it = this->lower_bound(x);
+        if (it == this->end() || compare_(x, *it)) {
+            return this->end();
+        }
+        return it;
+    }
+
+    size_type count(const Key& x) const {
+        return this->contains(x) ? 1 : 0;
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    size_type count(const K& x) const {
+        return this->contains(x) ? 1 : 0;
+    }
+
+    bool contains(const Key& x) const {
+        return this->find(x) != this->end();
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    bool contains(const K& x) const {
+        return this->find(x) != this->end();
+    }
+
+    // Returns an iterator to the least element not less than t, or end().
+    const_iterator lower_bound(const Key& t) const {
+        return this->lower_bound_impl(t);
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    const_iterator lower_bound(const K& x) const {
+        return this->lower_bound_impl(x);
+    }
+
+    friend bool operator==(const eytzinger_flat_set& a, const eytzinger_flat_set& b) {
+        // Equal sets of the same size have the same layout.
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+    friend bool operator!=(const eytzinger_flat_set& a, const eytzinger_flat_set& b) {
+        return !(a == b);
+    }
+
+private:
+    void sort_and_unique_impl() {
+        std::sort(c_.begin(), c_.end(), compare_);
+        auto it = eytzinger_detail::unique_helper(c_.begin(), c_.end(), compare_);
+        c_.erase(it, c_.end());
+    }
+
+    template<class K>
+    const_iterator lower_bound_impl(const K& x) const {
+        // Descend from the root, going right whenever the node is less than x.
+        // The bits of k below its leading one record the path taken; the answer
+        // is the last node at which we went left.
+        const size_t n = c_.size();
+        auto first = c_.begin();
+        size_t k = 1;
+        while (k <= n) {
+            eytzinger_detail::prefetch(std::addressof(first[std::min(16*k, n) - 1]));
+            k = 2*k + bool(compare_(first[k-1], x));
+        }
+        k >>= eytzinger_detail::countr_one(k) + 1;
+        return (k == 0) ? c_.end() : first + (k-1);
+    }
+
+    KeyContainer c_;
+    Compare compare_;
+};
+
+} // namespace sg14
@@ -31,9 +31,13 @@
 
 #include <stddef.h>
 #include <algorithm>
+#include <exception>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -48,6 +52,29 @@
 #define SG14_FLAT_MAP_THROW(x) throw (x)
 #endif
 
+#ifndef SG14_FLAT_MAP_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define SG14_FLAT_MAP_EXCEPTIONS 1
+#else
+#define SG14_FLAT_MAP_EXCEPTIONS 0
+#endif
+#endif
+
+#ifndef SG14_FLAT_MAP_USE_SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SG14_FLAT_MAP_USE_SSE2 1
+#else
+#define SG14_FLAT_MAP_USE_SSE2 0
+#endif
+#endif
+
+#if SG14_FLAT_MAP_USE_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#endif
+
 namespace sg14 {
 
 namespace flatmap_detail {
@@ -164,6 +191,295 @@ namespace flatmap_detail {
         flatmap_detail::sort_together(less, 0, head.size(), head.begin(), rest.begin()...);
     }
 
+    // Returns the end of the run that begins at left: the longest prefix of
+    // [left, right) that is either non-descending or non-ascending.
+    // A non-ascending run is reversed in place.
+    template<class Compare, class Head, class... Rest>
+    size_t find_run_together(Compare& less, size_t left, size_t right, Head head, Rest... rest) {
+        // Skip past any leading equal elements before deciding the run's direction.
+        size_t i = left + 1;
+        while (i != right && !less(*(head + i), *(head + (i-1))) && !less(*(head + (i-1)), *(head + i))) ++i;
+        if (i != right && less(*(head + i), *(head + (i-1)))) {
+            ++i;
+            while (i != right && !less(*(head + (i-1)), *(head + i))) ++i;
+            for (size_t lo = left, hi = i - 1; lo < hi; ++lo, --hi) {
+                flatmap_detail::swap_together(lo, hi, head, rest...);
+            }
+        } else {
+            while (i != right && !less(*(head + i), *(head + (i-1)))) ++i;
+        }
+        return i;
+    }
+
+    // Both [left, mid) and [mid, right) are sorted. Merge them,
+    // using ktmp and vtmp as scratch space for the left-hand run.
+    template<class Compare, class KeyIt, class MappedIt, class KeyBuffer, class MappedBuffer>
+    void merge_runs_together(Compare& less, size_t left, size_t mid, size_t right,
+                             KeyIt kbegin, MappedIt vbegin, KeyBuffer& ktmp, MappedBuffer& vtmp) {
+        // Elements of the left-hand run that are not greater than the first
+        // element of the right-hand run are already in place.
+        left = std::partition_point(kbegin + left, kbegin + mid, [&](const auto& elt) {
+            return !bool(less(*(kbegin + mid), elt));
+        }) - kbegin;
+        if (left == mid) {
+            return;
+        }
+        ktmp.clear();
+        vtmp.clear();
+        for (size_t i = left; i != mid; ++i) {
+            ktmp.push_back(std::move(*(kbegin + i)));
+            vtmp.push_back(std::move(*(vbegin + i)));
+        }
+        size_t i = 0;
+        size_t j = mid;
+        size_t w = left;
+        while (i != ktmp.size()) {
+            if (j != right && less(*(kbegin + j), ktmp[i])) {
+                *(kbegin + w) = std::move(*(kbegin + j));
+                *(vbegin + w) = std::move(*(vbegin + j));
+                ++j;
+            } else {
+                *(kbegin + w) = std::move(ktmp[i]);
+                *(vbegin + w) = std::move(vtmp[i]);
+                ++i;
+            }
+            ++w;
+        }
+    }
+
+    // Sorts input that is mostly in order already. Elements that are out of
+    // order are set aside, sorted separately, and merged back in; this costs
+    // O(n + m log m) for m misplaced elements. If m grows too large,
+    // falls back to sorting everything from scratch.
+    template<class Compare, class KeyContainer, class MappedContainer>
+    void sort_with_outliers_together(Compare& less, KeyContainer& keys, MappedContainer& values) {
+        auto kbegin = keys.begin();
+        auto vbegin = values.begin();
+        size_t n = keys.size();
+        std::vector<typename KeyContainer::value_type> ktmp;
+        std::vector<typename MappedContainer::value_type> vtmp;
+        constexpr size_t MaxPop = 8;
+        size_t w = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (w != 0 && less(*(kbegin + i), *(kbegin + (w-1)))) {
+                // Either this element is out of order, or the last few we kept are.
+                // If the next element is also less than the last one we kept,
+                // assume the latter, as long as there are only a few of them.
+                size_t j = 1;
+                while (j < w && j <= MaxPop && less(*(kbegin + i), *(kbegin + (w-1-j)))) ++j;
+                if (j <= MaxPop && i + 1 != n && less(*(kbegin + (i+1)), *(kbegin + (w-1)))) {
+                    for (; j != 0; --j) {
+                        --w;
+                        ktmp.push_back(std::move(*(kbegin + w)));
+                        vtmp.push_back(std::move(*(vbegin + w)));
+                    }
+                } else {
+                    ktmp.push_back(std::move(*(kbegin + i)));
+                    vtmp.push_back(std::move(*(vbegin + i)));
+                    if (ktmp.size() > n / 8) {
+                        for (size_t j = 0; j < ktmp.size(); ++j) {
+                            *(kbegin + (w+j)) = std::move(ktmp[j]);
+                            *(vbegin + (w+j)) = std::move(vtmp[j]);
+                        }
+                        flatmap_detail::sort_together(less, 0, n, kbegin, vbegin);
+                        return;
+                    }
+                    continue;
+                }
+            }
+            if (w != i) {
+                *(kbegin + w) = std::move(*(kbegin + i));
+                *(vbegin + w) = std::move(*(vbegin + i));
+            }
+            ++w;
+        }
+        flatmap_detail::sort_together(less, ktmp, vtmp);
+        // Merge backward, so that each element moves at most once.
+        size_t j = ktmp.size();
+        while (j != 0) {
+            --n;
+            if (w != 0 && less(ktmp[j-1], *(kbegin + (w-1)))) {
+                --w;
+                *(kbegin + n) = std::move(*(kbegin + w));
+                *(vbegin + n) = std::move(*(vbegin + w));
+            } else {
+                --j;
+                *(kbegin + n) = std::move(ktmp[j]);
+                *(vbegin + n) = std::move(vtmp[j]);
+            }
+        }
+    }
+
+    // Input that consists of a few sorted (or reverse-sorted) runs is
+    // sorted by merging those runs, in O(n log r) time for r runs;
+    // already-sorted input costs only n-1 comparisons.
+    template<class Compare, class KeyContainer, class MappedContainer>
+    void natural_sort_together(Compare& less, KeyContainer& keys, MappedContainer& values) {
+        constexpr size_t MaxRuns = 64;
+        auto kbegin = keys.begin();
+        auto vbegin = values.begin();
+        size_t n = keys.size();
+        std::vector<size_t> runs;
+        size_t i = 0;
+        while (i != n && runs.size() != MaxRuns) {
+            runs.push_back(i);
+            i = flatmap_detail::find_run_together(less, i, n, kbegin, vbegin);
+        }
+        if (i != n) {
+            flatmap_detail::sort_with_outliers_together(less, keys, values);
+            return;
+        } else if (runs.size() <= 1) {
+            return;
+        }
+        runs.push_back(n);
+        std::vector<typename KeyContainer::value_type> ktmp;
+        std::vector<typename MappedContainer::value_type> vtmp;
+        while (runs.size() > 2) {
+            size_t w = 0;
+            size_t r = 0;
+            for (; r + 2 < runs.size(); r += 2) {
+                flatmap_detail::merge_runs_together(less, runs[r], runs[r+1], runs[r+2], kbegin, vbegin, ktmp, vtmp);
+                runs[w++] = runs[r];
+            }
+            if (r + 1 < runs.size()) {
+                runs[w++] = runs[r];
+            }
+            runs[w++] = n;
+            runs.resize(w);
+        }
+    }
+
+    // Both [0, mid) and [mid, keys.size()) are sorted and unique.
+    // Merge them in place, dropping each element of [mid, keys.size())
+    // whose key is already present in [0, mid). Returns the merged size;
+    // the caller must erase the moved-from leftovers after that point.
+    template<class Compare, class KeyContainer, class MappedContainer>
+    size_t merge_unique_together(Compare& less, KeyContainer& keys, MappedContainer& values, size_t mid) {
+        auto kbegin = keys.begin();
+        auto vbegin = values.begin();
+        size_t n = keys.size();
+        std::vector<typename KeyContainer::value_type> ktmp;
+        std::vector<typename MappedContainer::value_type> vtmp;
+        ktmp.reserve(n - mid);
+        vtmp.reserve(n - mid);
+        size_t i = 0;
+        for (size_t j = mid; j < n; ++j) {
+            const auto& k = *(kbegin + j);
+            i = std::partition_point(kbegin + i, kbegin + mid, [&](const auto& elt) {
+                return bool(less(elt, k));
+            }) - kbegin;
+            if (i == mid || less(k, *(kbegin + i))) {
+                ktmp.push_back(std::move(*(kbegin + j)));
+                vtmp.push_back(std::move(*(vbegin + j)));
+            }
+        }
+        // Merge backward, so that each old element moves at most once.
+        size_t j = ktmp.size();
+        size_t w = mid + j;
+        i = mid;
+        while (j != 0) {
+            --w;
+            if (i != 0 && less(ktmp[j-1], *(kbegin + (i-1)))) {
+                --i;
+                *(kbegin + w) = std::move(*(kbegin + i));
+                *(vbegin + w) = std::move(*(vbegin + i));
+            } else {
+                --j;
+                *(kbegin + w) = std::move(ktmp[j]);
+                *(vbegin + w) = std::move(vtmp[j]);
+            }
+        }
+        return mid + ktmp.size();
+    }
+
+    struct thread_joiner {
+        std::vector<std::thread>& threads_;
+        ~thread_joiner() {
+            for (auto& t : threads_) {
+                t.join();
+            }
+        }
+    };
+
+    // Calls f(0), f(1), ..., f(count-1) concurrently, each on its own thread
+    // (f(0) on the calling thread), and waits for them all to finish.
+    // If any call throws, the first exception is rethrown once all the threads have finished.
+    template<class F>
+    void parallel_for(size_t count, const F& f) {
+#if SG14_FLAT_MAP_EXCEPTIONS
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto run = [&](size_t i) {
+            try {
+                f(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(error_mutex);
+                if (error == nullptr) {
+                    error = std::current_exception();
+                }
+            }
+        };
+#else
+        const F& run = f;
+#endif
+        {
+            std::vector<std::thread> threads;
+            threads.reserve(count);
+            thread_joiner joiner{threads};
+            for (size_t i = 1; i < count; ++i) {
+                threads.emplace_back(run, i);
+            }
+            run(0);
+        }
+#if SG14_FLAT_MAP_EXCEPTIONS
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+#endif
+    }
+
+    // Splits the input into one chunk per thread and sorts the chunks concurrently;
+    // then merges pairs of adjacent chunks concurrently, until one chunk remains.
+    // Each thread works with its own copy of the comparator.
+    template<class Compare, class KeyContainer, class MappedContainer>
+    void parallel_sort_together(const Compare& less, KeyContainer& keys, MappedContainer& values, size_t threads) {
+        constexpr size_t MinPerThread = 4096;
+        size_t n = keys.size();
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        threads = (std::min)(threads, n / MinPerThread);
+        if (threads <= 1) {
+            Compare comp = less;
+            flatmap_detail::natural_sort_together(comp, keys, values);
+            return;
+        }
+        auto kbegin = keys.begin();
+        auto vbegin = values.begin();
+        std::vector<size_t> bounds(threads + 1);
+        for (size_t i = 0; i <= threads; ++i) {
+            bounds[i] = n / threads * i + (std::min)(i, n % threads);
+        }
+        flatmap_detail::parallel_for(threads, [&](size_t t) {
+            Compare comp = less;
+            flatmap_detail::sort_together(comp, bounds[t], bounds[t+1], kbegin, vbegin);
+        });
+        while (bounds.size() > 2) {
+            flatmap_detail::parallel_for((bounds.size() - 1) / 2, [&](size_t p) {
+                Compare comp = less;
+                std::vector<typename KeyContainer::value_type> ktmp;
+                std::vector<typename MappedContainer::value_type> vtmp;
+                flatmap_detail::merge_runs_together(comp, bounds[2*p], bounds[2*p+1], bounds[2*p+2], kbegin, vbegin, ktmp, vtmp);
+            });
+            size_t w = 0;
+            for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+                bounds[w++] = bounds[r];
+            }
+            bounds[w++] = n;
+            bounds.resize(w);
+        }
+    }
+
     template<class It, class It2, class Compare>
     It unique_helper(It first, It last, It2 mapped, const Compare& compare) {
         It dfirst = first;
@@ -292,6 +608,245 @@ namespace flatmap_detail {
         return iter<K, V>(static_cast<K&&>(kit), static_cast<V&&>(vit));
     }
 
+    // P2363 constrains the heterogeneous try_emplace so that it can't be
+    // confused with the overload taking a hint.
+    template<class K, class Key, class It, class CIt>
+    using is_transparent_key_arg = std::integral_constant<bool,
+        std::is_constructible<Key, K&&>::value &&
+        !std::is_convertible<K&&, It>::value &&
+        !std::is_convertible<K&&, CIt>::value
+    >;
+
+    // Lookups on a container of arithmetic keys ordered by std::less can skip
+    // the comparator and binary-search the contiguous key array directly.
+    template<class KeyContainer, class = void>
+    struct has_contiguous_data : std::false_type {};
+    template<class KeyContainer>
+    struct has_contiguous_data<KeyContainer, void_t<decltype(std::declval<const KeyContainer&>().data())>> : std::is_same<
+        decltype(std::declval<const KeyContainer&>().data()),
+        const typename KeyContainer::value_type*
+    > {};
+
+    template<class Key, class Compare, class KeyContainer>
+    using is_branchless_searchable = std::integral_constant<bool,
+        std::is_arithmetic<Key>::value &&
+        (std::is_same<Compare, std::less<Key>>::value || std::is_same<Compare, std::less<>>::value) &&
+        std::is_same<typename KeyContainer::value_type, Key>::value &&
+        has_contiguous_data<KeyContainer>::value
+    >;
+
+    // Returns the number of elements in [p, p+n) that are less than value.
+    template<class T>
+    size_t count_less(const T *p, size_t n, const T& value) {
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i) {
+            count += (p[i] < value);
+        }
+        return count;
+    }
+
+#if SG14_FLAT_MAP_USE_SSE2
+    // Signed compares work for unsigned keys too, once both sides have their top bit flipped.
+    template<class T>
+    size_t count_less_simd(const T *p, size_t n, T value) {
+        const int bias = std::is_signed<T>::value ? 0 : int(0x80000000u);
+        size_t i = 0;
+#if defined(__AVX2__)
+        __m256i bias8 = _mm256_set1_epi32(bias);
+        __m256i value8 = _mm256_xor_si256(_mm256_set1_epi32(int(value)), bias8);
+        __m256i acc8 = _mm256_setzero_si256();
+        for (; i + 8 <= n; i += 8) {
+            __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), bias8);
+            acc8 = _mm256_sub_epi32(acc8, _mm256_cmpgt_epi32(value8, x));
+        }
+        __m128i acc = _mm_add_epi32(_mm256_castsi256_si128(acc8), _mm256_extracti128_si256(acc8, 1));
+#else
+        __m128i acc = _mm_setzero_si128();
+#endif
+        __m128i bias4 = _mm_set1_epi32(bias);
+        __m128i value4 = _mm_xor_si128(_mm_set1_epi32(int(value)), bias4);
+        for (; i + 4 <= n; i += 4) {
+            __m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), bias4);
+            acc = _mm_sub_epi32(acc, _mm_cmplt_epi32(x, value4));
+        }
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+        size_t count = size_t(_mm_cvtsi128_si32(acc));
+        for (; i < n; ++i) {
+            count += (p[i] < value);
+        }
+        return count;
+    }
+    inline size_t count_less(const int *p, size_t n, const int& value) {
+        return flatmap_detail::count_less_simd(p, n, value);
+    }
+    inline size_t count_less(const unsigned *p, size_t n, const unsigned& value) {
+        return flatmap_detail::count_less_simd(p, n, value);
+    }
+#endif // SG14_FLAT_MAP_USE_SSE2
+
+    // Equivalent to std::lower_bound(first, first+n, value), but the loop
+    // contains no data-dependent branches: each step halves the range with a
+    // conditional move, and the last few candidates are compared all at once.
+    template<class T>
+    const T *branchless_lower_bound(const T *first, size_t n, const T& value) {
+        while (n > 16) {
+            size_t half = n / 2;
+            first = (first[half] < value) ? first + half : first;
+            n -= half;
+        }
+        return first + flatmap_detail::count_less(first, n, value);
+    }
+
+    inline void prefetch(const void *p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#elif SG14_FLAT_MAP_USE_SSE2
+        _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+        (void)p;
+#endif
+    }
+
+    // Proxy iterators (such as vector<bool>'s) have no address to prefetch.
+    template<class It>
+    void prefetch_element(It it, std::true_type) { flatmap_detail::prefetch(std::addressof(*it)); }
+    template<class It>
+    void prefetch_element(It, std::false_type) {}
+    template<class It>
+    void prefetch_element(It it) {
+        flatmap_detail::prefetch_element(it, std::is_lvalue_reference<decltype(*it)>());
+    }
+
+    // Heterogeneous queries might not be comparable to each other in the same way.
+    template<class ForwardIt, class Compare>
+    bool queries_are_sorted(ForwardIt first, ForwardIt last, const Compare& compare, std::true_type) {
+        return std::is_sorted(first, last, compare);
+    }
+    template<class ForwardIt, class Compare>
+    bool queries_are_sorted(ForwardIt, ForwardIt, const Compare&, std::false_type) {
+        return false;
+    }
+
+    // Calls emit(q, i) for each query q in [qfirst, qlast), in order, where
+    // i is the index of the lower bound of q in the sorted range [kfirst, kfirst+n).
+    // Sorted queries are resolved by galloping forward from the previous answer.
+    // Otherwise, the queries are binary-searched in groups, one level at a time,
+    // so that the cache misses of a whole group are in flight at once.
+    template<class KeyIt, class Compare, class ForwardIt, class F>
+    void lower_bound_many(KeyIt kfirst, size_t n, const Compare& compare, ForwardIt qfirst, ForwardIt qlast, F&& emit) {
+        using QueryIsKey = std::is_same<
+            typename std::iterator_traits<ForwardIt>::value_type,
+            typename std::iterator_traits<KeyIt>::value_type
+        >;
+        if (flatmap_detail::queries_are_sorted(qfirst, qlast, compare, QueryIsKey())) {
+            size_t prev = 0;
+            for (; qfirst != qlast; ++qfirst) {
+                size_t lo = prev;
+                size_t hi = prev;
+                size_t step = 1;
+                while (hi < n && bool(compare(kfirst[hi], *qfirst))) {
+                    lo = hi + 1;
+                    hi += step;
+                    step *= 2;
+                }
+                auto kit = std::partition_point(kfirst + lo, kfirst + (std::min)(hi, n), [&](const auto& elt) {
+                    return bool(compare(elt, *qfirst));
+                });
+                prev = size_t(kit - kfirst);
+                emit(*qfirst, prev);
+            }
+            return;
+        }
+        constexpr size_t G = 8;
+        ForwardIt queries[G];
+        size_t bases[G];
+        while (qfirst != qlast) {
+            size_t m = 0;
+            for (; m < G && qfirst != qlast; ++m, ++qfirst) {
+                queries[m] = qfirst;
+                bases[m] = 0;
+            }
+            size_t len = n;
+            while (len > 1) {
+                size_t half = len / 2;
+                size_t next_half = (len - half) / 2;
+                for (size_t j = 0; j < m; ++j) {
+                    flatmap_detail::prefetch_element(kfirst + (bases[j] + next_half));
+                    flatmap_detail::prefetch_element(kfirst + (bases[j] + half + next_half));
+                }
+                for (size_t j = 0; j < m; ++j) {
+                    bases[j] = bool(compare(kfirst[bases[j] + half], *queries[j])) ? bases[j] + half : bases[j];
+                }
+                len -= half;
+            }
+            for (size_t j = 0; j < m; ++j) {
+                size_t i = bases[j] + size_t(len == 1 && bool(compare(kfirst[bases[j]], *queries[j])));
+                emit(*queries[j], i);
+            }
+        }
+    }
+
+    // Storage for interleaved_flat_map: N keys followed by their N mapped values,
+    // so that a lookup usually finds the key and its value in the same cache line.
+    template<class Key, class Mapped, size_t N>
+    struct interleaved_block {
+        static constexpr size_t block_size = N;
+        Key keys[N];
+        Mapped values[N];
+    };
+
+    // A random-access iterator over one lane (keys or values) of an array of blocks.
+    // Block and T are const-qualified for the const lanes.
+    template<class Block, class T, bool IsKeyLane>
+    class block_lane_iterator {
+        template<class, class, bool> friend class block_lane_iterator;
+        static constexpr size_t N = std::remove_const<Block>::type::block_size;
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = typename std::remove_const<T>::type;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::random_access_iterator_tag;
+
+        block_lane_iterator() = default;
+        explicit block_lane_iterator(Block *blocks, size_t i) : blocks_(blocks), i_(i) {}
+
+        template<class B2, class T2,
+                 class = typename std::enable_if<std::is_convertible<B2*, Block*>::value && std::is_convertible<T2*, T*>::value>::type>
+        block_lane_iterator(const block_lane_iterator<B2, T2, IsKeyLane>& other) : blocks_(other.blocks_), i_(other.i_) {}
+
+        reference operator*() const { return lane(blocks_[i_ / N], std::integral_constant<bool, IsKeyLane>())[i_ % N]; }
+        pointer operator->() const { return &**this; }
+        reference operator[](ptrdiff_t n) const { return *(*this + n); }
+
+        block_lane_iterator& operator++() { ++i_; return *this; }
+        block_lane_iterator& operator--() { --i_; return *this; }
+        block_lane_iterator operator++(int) { block_lane_iterator result(*this); ++i_; return result; }
+        block_lane_iterator operator--(int) { block_lane_iterator result(*this); --i_; return result; }
+        block_lane_iterator& operator+=(ptrdiff_t n) { i_ += n; return *this; }
+        block_lane_iterator& operator-=(ptrdiff_t n) { i_ -= n; return *this; }
+        friend block_lane_iterator operator+(block_lane_iterator it, ptrdiff_t n) { it += n; return it; }
+        friend block_lane_iterator operator+(ptrdiff_t n, block_lane_iterator it) { it += n; return it; }
+        friend block_lane_iterator operator-(block_lane_iterator it, ptrdiff_t n) { it -= n; return it; }
+        friend ptrdiff_t operator-(const block_lane_iterator& a, const block_lane_iterator& b) { return ptrdiff_t(a.i_ - b.i_); }
+        friend bool operator==(const block_lane_iterator& a, const block_lane_iterator& b) { return a.i_ == b.i_; }
+        friend bool operator!=(const block_lane_iterator& a, const block_lane_iterator& b) { return a.i_ != b.i_; }
+        friend bool operator<(const block_lane_iterator& a, const block_lane_iterator& b) { return a.i_ < b.i_; }
+        friend bool operator<=(const block_lane_iterator& a, const block_lane_iterator& b) { return a.i_ <= b.i_; }
+        friend bool operator>(const block_lane_iterator& a, const block_lane_iterator& b) { return a.i_ > b.i_; }
+        friend bool operator>=(const block_lane_iterator& a, const block_lane_iterator& b) { return a.i_ >= b.i_; }
+
+        size_t index() const { return i_; }
+
+    private:
+        static auto lane(Block& b, std::true_type) -> decltype((b.keys)) { return b.keys; }
+        static auto lane(Block& b, std::false_type) -> decltype((b.values)) { return b.values; }
+
+        Block *blocks_ = nullptr;
+        size_t i_ = 0;
+    };
+
 } // namespace flatmap_detail
 
 #ifndef SG14_HAS_SORTED_UNIQUE
@@ -306,6 +861,20 @@ constexpr sorted_unique_t sorted_unique {};
 
 #endif // SG14_HAS_SORTED_UNIQUE
 
+#ifndef SG14_HAS_SORT_THREADS
+#define SG14_HAS_SORT_THREADS
+
+// Passed to a constructor or to replace() to sort the input on that many
+// threads. Zero means std::thread::hardware_concurrency().
+struct sort_threads {
+    explicit sort_threads(size_t count) : count_(count) {}
+    size_t count() const { return count_; }
+private:
+    size_t count_;
+};
+
+#endif // SG14_HAS_SORT_THREADS
+
 template<
     class Key,
     class Mapped,
@@ -447,6 +1016,22 @@ public:
     flat_map(InputIterator first, InputIterator last, const Alloc& a)
         : flat_map(first, last, Compare(), a) {}
 
+    template<class InputIterator,
+             class = typename std::enable_if<flatmap_detail::qualifies_as_input_iterator<InputIterator>::value>::type>
+    flat_map(sort_threads threads, InputIterator first, InputIterator last, const Compare& comp = Compare())
+        : compare_(comp)
+    {
+        flatmap_detail::InvariantRestoringGuard<flat_map> guard(this);
+        while (first != last) {
+            std::pair<Key, Mapped> t(*first);
+            keys_.insert(keys_.end(), static_cast<Key&&>(t.first));
+            values_.insert(values_.end(), static_cast<Mapped&&>(t.second));
+            ++first;
+        }
+        this->sort_and_unique_impl(threads);
+        guard.complete();
+    }
+
     template<class InputIterator,
              class = typename std::enable_if<flatmap_detail::qualifies_as_input_iterator<InputIterator>::value>::type>
     flat_map(sorted_unique_t, InputIterator first, InputIterator last, const Compare& comp = Compare())
@@ -556,6 +1141,13 @@ public:
         return try_emplace(static_cast<Key&&>(x)).first->second;
     }
 
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent,
+             class = typename std::enable_if<flatmap_detail::is_transparent_key_arg<K, Key, iterator, const_iterator>::value>::type>
+    mapped_reference operator[](K&& x) {
+        return try_emplace(static_cast<K&&>(x)).first->second;
+    }
+
     mapped_reference at(const Key& k) {
         auto it = this->find(k);
         if (it == end()) {
@@ -590,8 +1182,17 @@ public:
     }
 
     template<class... Args>
-    iterator emplace_hint(const_iterator, Args&&... args) {
-        return this->emplace(static_cast<Args&&>(args)...).first;
+    iterator emplace_hint(const_iterator position, Args&&... args) {
+        std::pair<Key, Mapped> t(static_cast<Args&&>(args)...);
+        auto where = this->lower_bound_index_near(position, t.first);
+        auto kit = keys_.begin() + where.first;
+        auto vit = values_.begin() + where.first;
+        if (where.second || kit == keys_.end() || compare_(t.first, *kit)) {
+            // TODO: we must make this exception-safe
+            kit = keys_.emplace(kit, static_cast<Key&&>(t.first));
+            vit = values_.emplace(vit, static_cast<Mapped&&>(t.second));
+        }
+        return flatmap_detail::make_iterator(kit, vit);
     }
 
     std::pair<iterator, bool> insert(const value_type& x) {
@@ -635,20 +1236,20 @@ public:
     template<class InputIterator,
              class = typename std::enable_if<flatmap_detail::qualifies_as_input_iterator<InputIterator>::value>::type>
     void insert(sorted_unique_t, InputIterator first, InputIterator last) {
-        // TODO: if InputIterator is bidirectional, this loop should (go backward??)
-        // TODO: if we're inserting lots of elements, stick them at the end and then sort
-        auto it = begin();
+        flatmap_detail::InvariantRestoringGuard<flat_map> guard(this);
+        size_type oldsize = keys_.size();
         while (first != last) {
             std::pair<Key, Mapped> t(*first);
-            it = std::partition_point(it, this->end(), [&](const auto& elt) {
-                return bool(compare_(elt.first, t.first));
-            });
-            if (it == this->end() || bool(compare_(t.first, it->first))) {
-                it = this->emplace_hint(it, std::move(t));
-            }
-            ++it;
+            keys_.insert(keys_.end(), static_cast<Key&&>(t.first));
+            values_.insert(values_.end(), static_cast<Mapped&&>(t.second));
             ++first;
         }
+        if (keys_.size() != oldsize) {
+            size_type newsize = flatmap_detail::merge_unique_together(compare_, keys_, values_, oldsize);
+            keys_.erase(keys_.begin() + newsize, keys_.end());
+            values_.erase(values_.begin() + newsize, values_.end());
+        }
+        guard.complete();
     }
 
     void insert(std::initializer_list<value_type> il) {
@@ -724,6 +1325,14 @@ public:
         guard.complete();
     }
 
+    void replace(sort_threads threads, KeyContainer keys, MappedContainer values) {
+        flatmap_detail::InvariantRestoringGuard<flat_map> guard(this);
+        keys_ = static_cast<KeyContainer&&>(keys);
+        values_ = static_cast<MappedContainer&&>(values);
+        this->sort_and_unique_impl(threads);
+        guard.complete();
+    }
+
     void replace(sorted_unique_t, KeyContainer keys, MappedContainer values) {
         flatmap_detail::InvariantRestoringGuard<flat_map> guard(this);
         keys_ = static_cast<KeyContainer&&>(keys);
@@ -733,42 +1342,39 @@ public:
 
     template<class... Args>
     std::pair<iterator, bool> try_emplace(const Key& k, Args&&... args) {
-        auto kit = std::lower_bound(keys_.begin(), keys_.end(), k, std::ref(compare_));
-        auto vit = values_.begin() + (kit - keys_.begin());
-        if (kit == keys_.end() || compare_(k, *kit)) {
-            kit = keys_.insert(kit, k);
-            // TODO: we must make this exception-safe if the container throws
-            vit = values_.emplace(vit, static_cast<Args&&>(args)...);
-            return {flatmap_detail::make_iterator(kit, vit), true};
-        } else {
-            return {flatmap_detail::make_iterator(kit, vit), false};
-        }
+        return this->try_emplace_at({this->lower_bound_index(k), false}, k, static_cast<Args&&>(args)...);
     }
 
     template<class... Args>
     std::pair<iterator, bool> try_emplace(Key&& k, Args&&... args) {
-        auto kit = std::lower_bound(keys_.begin(), keys_.end(), k, std::ref(compare_));
-        auto vit = values_.begin() + (kit - keys_.begin());
-        if (kit == keys_.end() || compare_(k, *kit)) {
-            kit = keys_.insert(kit, static_cast<Key&&>(k));
-            // TODO: we must make this exception-safe if the container throws
-            vit = values_.emplace(vit, static_cast<Args&&>(args)...);
-            return {flatmap_detail::make_iterator(kit, vit), true};
-        } else {
-            return {flatmap_detail::make_iterator(kit, vit), false};
-        }
+        return this->try_emplace_at({this->lower_bound_index(k), false}, static_cast<Key&&>(k), static_cast<Args&&>(args)...);
+    }
+
+    // The heterogeneous overloads search with the borrowed key, and convert it
+    // to a Key only when an element is actually inserted.
+    template<class K, class... Args,
+             class Compare_ = Compare, class = typename Compare_::is_transparent,
+             class = typename std::enable_if<flatmap_detail::is_transparent_key_arg<K, Key, iterator, const_iterator>::value>::type>
+    std::pair<iterator, bool> try_emplace(K&& x, Args&&... args) {
+        return this->try_emplace_at({this->lower_bound_index(x), false}, static_cast<K&&>(x), static_cast<Args&&>(args)...);
     }
 
-    // TODO: use the hint, here
+    // The hinted overloads search as emplace_hint does.
     template<class... Args>
-    iterator try_emplace(const_iterator, const Key& k, Args&&... args) {
-        return try_emplace(k, static_cast<Args&&>(args)...).first;
+    iterator try_emplace(const_iterator position, const Key& k, Args&&... args) {
+        return this->try_emplace_at(this->lower_bound_index_near(position, k), k, static_cast<Args&&>(args)...).first;
     }
 
-    // TODO: use the hint, here
     template<class... Args>
-    iterator try_emplace(const_iterator, Key&& k, Args&&... args) {
-        return try_emplace(static_cast<Key&&>(k), static_cast<Args&&>(args)...).first;
+    iterator try_emplace(const_iterator position, Key&& k, Args&&... args) {
+        return this->try_emplace_at(this->lower_bound_index_near(position, k), static_cast<Key&&>(k), static_cast<Args&&>(args)...).first;
+    }
+
+    template<class K, class... Args,
+             class Compare_ = Compare, class = typename Compare_::is_transparent,
+             class = typename std::enable_if<flatmap_detail::is_transparent_key_arg<K, Key, iterator, const_iterator>::value>::type>
+    iterator try_emplace(const_iterator position, K&& x, Args&&... args) {
+        return this->try_emplace_at(this->lower_bound_index_near(position, x), static_cast<K&&>(x), static_cast<Args&&>(args)...).first;
     }
 
     template<class M>
@@ -793,24 +1399,48 @@ public:
         return result;
     }
 
-    // TODO: use the hint, here
     template<class M>
-    iterator insert_or_assign(const_iterator, const Key& k, M&& obj) {
+    iterator insert_or_assign(const_iterator position, const Key& k, M&& obj) {
         static_assert(std::is_assignable<Mapped&, M>::value, "");
         static_assert(sizeof( Mapped(static_cast<M&&>(obj)) ) != 0, "");
-        auto result = try_emplace(k, static_cast<M&&>(obj));
+        auto result = this->try_emplace_at(this->lower_bound_index_near(position, k), k, static_cast<M&&>(obj));
         if (!result.second) {
             result.first->second = static_cast<M&&>(obj);
         }
         return result.first;
     }
 
-    // TODO: use the hint, here
     template<class M>
-    iterator insert_or_assign(const_iterator, Key&& k, M&& obj) {
+    iterator insert_or_assign(const_iterator position, Key&& k, M&& obj) {
         static_assert(std::is_assignable<Mapped&, M>::value, "");
         static_assert(sizeof( Mapped(static_cast<M&&>(obj)) ) != 0, "");
-        auto result = try_emplace(static_cast<Key&&>(k), static_cast<M&&>(obj));
+        auto result = this->try_emplace_at(this->lower_bound_index_near(position, k), static_cast<Key&&>(k), static_cast<M&&>(obj));
+        if (!result.second) {
+            result.first->second = static_cast<M&&>(obj);
+        }
+        return result.first;
+    }
+
+    template<class K, class M,
+             class Compare_ = Compare, class = typename Compare_::is_transparent,
+             class = typename std::enable_if<flatmap_detail::is_transparent_key_arg<K, Key, iterator, const_iterator>::value>::type>
+    std::pair<iterator, bool> insert_or_assign(K&& x, M&& obj) {
+        static_assert(std::is_assignable<Mapped&, M>::value, "");
+        static_assert(sizeof( Mapped(static_cast<M&&>(obj)) ) != 0, "");
+        auto result = try_emplace(static_cast<K&&>(x), static_cast<M&&>(obj));
+        if (!result.second) {
+            result.first->second = static_cast<M&&>(obj);
+        }
+        return result;
+    }
+
+    template<class K, class M,
+             class Compare_ = Compare, class = typename Compare_::is_transparent,
+             class = typename std::enable_if<flatmap_detail::is_transparent_key_arg<K, Key, iterator, const_iterator>::value>::type>
+    iterator insert_or_assign(const_iterator position, K&& x, M&& obj) {
+        static_assert(std::is_assignable<Mapped&, M>::value, "");
+        static_assert(sizeof( Mapped(static_cast<M&&>(obj)) ) != 0, "");
+        auto result = this->try_emplace_at(this->lower_bound_index_near(position, x), static_cast<K&&>(x), static_cast<M&&>(obj));
         if (!result.second) {
             result.first->second = static_cast<M&&>(obj);
         }
@@ -951,18 +1581,47 @@ public:
         return this->find(x) != this->end();
     }
 
-    iterator lower_bound(const Key& k) {
-        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
-            return bool(compare_(elt, k));
+    // Looks up each key in [first, last), and writes to result the iterator
+    // that find would have returned for it. This is faster than calling find
+    // in a loop, especially when [first, last) is sorted.
+    template<class ForwardIterator, class OutputIterator>
+    OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator result) {
+        flatmap_detail::lower_bound_many(keys_.cbegin(), keys_.size(), compare_, first, last, [&](const auto& k, size_t i) {
+            bool found = (i != keys_.size()) && !bool(compare_(k, keys_[i]));
+            *result = found ? this->begin() + i : this->end();
+            ++result;
+        });
+        return result;
+    }
+
+    template<class ForwardIterator, class OutputIterator>
+    OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator result) const {
+        flatmap_detail::lower_bound_many(keys_.cbegin(), keys_.size(), compare_, first, last, [&](const auto& k, size_t i) {
+            bool found = (i != keys_.size()) && !bool(compare_(k, keys_[i]));
+            *result = found ? this->begin() + i : this->end();
+            ++result;
+        });
+        return result;
+    }
+
+    // Writes to result whether each key in [first, last) is present.
+    template<class ForwardIterator, class OutputIterator>
+    OutputIterator contains_many(ForwardIterator first, ForwardIterator last, OutputIterator result) const {
+        flatmap_detail::lower_bound_many(keys_.cbegin(), keys_.size(), compare_, first, last, [&](const auto& k, size_t i) {
+            *result = (i != keys_.size()) && !bool(compare_(k, keys_[i]));
+            ++result;
         });
+        return result;
+    }
+
+    iterator lower_bound(const Key& k) {
+        auto kit = keys_.begin() + this->lower_bound_index(k);
         auto vit = values_.begin() + (kit - keys_.begin());
         return flatmap_detail::make_iterator(kit, vit);
     }
 
     const_iterator lower_bound(const Key& k) const {
-        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
-            return bool(compare_(elt, k));
-        });
+        auto kit = keys_.begin() + this->lower_bound_index(k);
         auto vit = values_.begin() + (kit - keys_.begin());
         return flatmap_detail::make_iterator(kit, vit);
     }
@@ -1024,9 +1683,7 @@ public:
     }
 
     std::pair<iterator, iterator> equal_range(const Key& k) {
-        auto kit1 = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
-            return bool(compare_(elt, k));
-        });
+        auto kit1 = keys_.begin() + this->lower_bound_index(k);
         auto kit2 = std::partition_point(kit1, keys_.end(), [&](const auto& elt) {
             return !bool(compare_(k, elt));
         });
@@ -1039,9 +1696,7 @@ public:
     }
 
     std::pair<const_iterator, const_iterator> equal_range(const Key& k) const {
-        auto kit1 = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
-            return bool(compare_(elt, k));
-        });
+        auto kit1 = keys_.begin() + this->lower_bound_index(k);
         auto kit2 = std::partition_point(kit1, keys_.end(), [&](const auto& elt) {
             return !bool(compare_(k, elt));
         });
@@ -1107,13 +1762,83 @@ public:
 
 private:
     void sort_and_unique_impl() {
-        flatmap_detail::sort_together(compare_, keys_, values_);
+        flatmap_detail::natural_sort_together(compare_, keys_, values_);
+        auto kit = flatmap_detail::unique_helper(keys_.begin(), keys_.end(), values_.begin(), compare_);
+        auto vit = values_.begin() + (kit - keys_.begin());
+        auto it = flatmap_detail::make_iterator(kit, vit);
+        this->erase(it, end());
+    }
+
+    void sort_and_unique_impl(sort_threads threads) {
+        flatmap_detail::parallel_sort_together(compare_, keys_, values_, threads.count());
         auto kit = flatmap_detail::unique_helper(keys_.begin(), keys_.end(), values_.begin(), compare_);
         auto vit = values_.begin() + (kit - keys_.begin());
         auto it = flatmap_detail::make_iterator(kit, vit);
         this->erase(it, end());
     }
 
+    size_t lower_bound_index(const Key& k) const {
+        using UseBranchless = flatmap_detail::is_branchless_searchable<Key, Compare, KeyContainer>;
+        return this->lower_bound_index_impl(k, UseBranchless());
+    }
+
+    // Heterogeneous keys always take the generic path.
+    template<class K>
+    size_t lower_bound_index(const K& x) const {
+        return this->lower_bound_index_impl(x, std::false_type());
+    }
+
+    // Returns lower_bound_index(x), using the hint, and whether x is known to be absent.
+    // If the hint is correct, x belongs immediately before it, and we needn't search at all.
+    // Otherwise, search only the side of the hint where x belongs.
+    template<class K>
+    std::pair<size_t, bool> lower_bound_index_near(const_iterator position, const K& x) const {
+        auto kfirst = keys_.cbegin();
+        auto klast = keys_.cend();
+        auto kit = position.private_impl_getkey();
+        if (kit != klast && !bool(compare_(x, *kit))) {
+            kfirst = kit;
+        } else if (kit != kfirst && !bool(compare_(*std::prev(kit), x))) {
+            klast = std::prev(kit);
+        } else {
+            return {size_t(kit - keys_.cbegin()), true};
+        }
+        kit = std::partition_point(kfirst, klast, [&](const auto& elt) {
+            return bool(compare_(elt, x));
+        });
+        return {size_t(kit - keys_.cbegin()), false};
+    }
+
+    // Inserts a Key made from k, and a Mapped made from args, at index where.first
+    // (which must be lower_bound_index(k)), unless k is already there.
+    // If where.second, k is known to be absent.
+    template<class K, class... Args>
+    std::pair<iterator, bool> try_emplace_at(std::pair<size_t, bool> where, K&& k, Args&&... args) {
+        auto kit = keys_.begin() + where.first;
+        auto vit = values_.begin() + where.first;
+        if (where.second || kit == keys_.end() || compare_(k, *kit)) {
+            kit = keys_.emplace(kit, static_cast<K&&>(k));
+            // TODO: we must make this exception-safe if the container throws
+            vit = values_.emplace(vit, static_cast<Args&&>(args)...);
+            return {flatmap_detail::make_iterator(kit, vit), true};
+        } else {
+            return {flatmap_detail::make_iterator(kit, vit), false};
+        }
+    }
+
+    template<class K>
+    size_t lower_bound_index_impl(const K& k, std::false_type) const {
+        auto kit = std::partition_point(keys_.begin(), keys_.end(), [&](const auto& elt) {
+            return bool(compare_(elt, k));
+        });
+        return kit - keys_.begin();
+    }
+
+    size_t lower_bound_index_impl(const Key& k, std::true_type) const {
+        const Key *first = keys_.data();
+        return flatmap_detail::branchless_lower_bound(first, keys_.size(), k) - first;
+    }
+
     KeyContainer keys_;
     MappedContainer values_;
     Compare compare_;
@@ -1148,4 +1873,524 @@ flat_map(std::from_range_t, R&&, Compare = Compare())
 
 #endif // __cpp_deduction_guides
 
+// interleaved_flat_map stores its elements in an array of blocks, each holding
+// BlockSize keys followed by their BlockSize mapped values. For small key and
+// mapped types, a successful lookup then touches one cache line instead of one
+// in each of flat_map's two containers. Key and Mapped must be default-constructible,
+// because the unused tail of the last block holds value-initialized elements.
+template<
+    class Key,
+    class Mapped,
+    class Compare = std::less<Key>,
+    size_t BlockSize = 8
+>
+class interleaved_flat_map {
+    static_assert(BlockSize != 0, "");
+    static_assert(std::is_default_constructible<Key>::value && std::is_default_constructible<Mapped>::value, "");
+    static_assert(!std::is_const<Key>::value && !std::is_const<Mapped>::value, "");
+    static_assert(!std::is_reference<Key>::value && !std::is_reference<Mapped>::value, "");
+    static_assert(std::is_convertible<decltype(std::declval<const Compare&>()(std::declval<const Key&>(), std::declval<const Key&>())), bool>::value, "");
+
+    using block_type = flatmap_detail::interleaved_block<Key, Mapped, BlockSize>;
+    using key_iterator = flatmap_detail::block_lane_iterator<const block_type, const Key, true>;
+    using mapped_iterator = flatmap_detail::block_lane_iterator<block_type, Mapped, false>;
+    using const_mapped_iterator = flatmap_detail::block_lane_iterator<const block_type, const Mapped, false>;
+public:
+    using key_type = Key;
+    using mapped_type = Mapped;
+    using value_type = std::pair<const Key, Mapped>;
+    using key_compare = Compare;
+    using reference = std::pair<const Key&, Mapped&>;
+    using const_reference = std::pair<const Key&, const Mapped&>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using iterator = flatmap_detail::iter<key_iterator, mapped_iterator>;
+    using const_iterator = flatmap_detail::iter<key_iterator, const_mapped_iterator>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    static constexpr size_t block_size = BlockSize;
+
+    interleaved_flat_map() : interleaved_flat_map(Compare()) {}
+
+    explicit interleaved_flat_map(const Compare& comp) : size_(0), compare_(comp) {}
+
+    template<class InputIterator,
+             class = typename std::enable_if<flatmap_detail::qualifies_as_input_iterator<InputIterator>::value>::type>
+    interleaved_flat_map(InputIterator first, InputIterator last, const Compare& comp = Compare())
+        : size_(0), compare_(comp)
+    {
+        std::vector<std::pair<Key, Mapped>> v(first, last);
+        std::stable_sort(v.begin(), v.end(), [&](const auto& a, const auto& b) {
+            return bool(compare_(a.first, b.first));
+        });
+        auto it = std::unique(v.begin(), v.end(), [&](const auto& a, const auto& b) {
+            return !bool(compare_(a.first, b.first));
+        });
+        v.erase(it, v.end());
+        this->assign_sorted_impl(v);
+    }
+
+    template<class InputIterator,
+             class = typename std::enable_if<flatmap_detail::qualifies_as_input_iterator<InputIterator>::value>::type>
+    interleaved_flat_map(sorted_unique_t, InputIterator first, InputIterator last, const Compare& comp = Compare())
+        : size_(0), compare_(comp)
+    {
+        std::vector<std::pair<Key, Mapped>> v(first, last);
+        this->assign_sorted_impl(v);
+    }
+
+    interleaved_flat_map(std::initializer_list<value_type> il, const Compare& comp = Compare())
+        : interleaved_flat_map(il.begin(), il.end(), comp) {}
+
+    interleaved_flat_map(sorted_unique_t s, std::initializer_list<value_type> il, const Compare& comp = Compare())
+        : interleaved_flat_map(s, il.begin(), il.end(), comp) {}
+
+    iterator begin() noexcept { return make_iterator_at(0); }
+    const_iterator begin() const noexcept { return make_iterator_at(0); }
+    iterator end() noexcept { return make_iterator_at(size_); }
+    const_iterator end() const noexcept { return make_iterator_at(size_); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+#if __cplusplus >= 201703L
+    [[nodiscard]]
+#endif
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return blocks_.size() * BlockSize; }
+
+    Mapped& operator[](const Key& x) {
+        return try_emplace(x).first->second;
+    }
+
+    Mapped& operator[](Key&& x) {
+        return try_emplace(static_cast<Key&&>(x)).first->second;
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent,
+             class = typename std::enable_if<flatmap_detail::is_transparent_key_arg<K, Key, iterator, const_iterator>::value>::type>
+    Mapped& operator[](K&& x) {
+        return try_emplace(static_cast<K&&>(x)).first->second;
+    }
+
+    Mapped& at(const Key& k) {
+        auto it = this->find(k);
+        if (it == end()) {
+            SG14_FLAT_MAP_THROW(std::out_of_range("interleaved_flat_map::at"));
+        }
+        return it->second;
+    }
+
+    const Mapped& at(const Key& k) const {
+        auto it = this->find(k);
+        if (it == end()) {
+            SG14_FLAT_MAP_THROW(std::out_of_range("interleaved_flat_map::at"));
+        }
+        return it->second;
+    }
+
+    template<class... Args, class = decltype(std::pair<Key, Mapped>(std::declval<Args&&>()...), void())>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        std::pair<Key, Mapped> t(static_cast<Args&&>(args)...);
+        return this->insert_or_find_impl(static_cast<Key&&>(t.first), static_cast<Mapped&&>(t.second));
+    }
+
+    template<class... Args>
+    iterator emplace_hint(const_iterator position, Args&&... args) {
+        std::pair<Key, Mapped> t(static_cast<Args&&>(args)...);
+        size_t i = this->lower_bound_index_near(position.private_impl_getkey().index(), t.first);
+        if (i == size_ || compare_(t.first, key_at(i))) {
+            this->insert_at(i, static_cast<Key&&>(t.first), static_cast<Mapped&&>(t.second));
+        }
+        return make_iterator_at(i);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& x) {
+        return this->emplace(x);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& x) {
+        return this->emplace(static_cast<value_type&&>(x));
+    }
+
+    iterator insert(const_iterator position, const value_type& x) {
+        return this->emplace_hint(position, x);
+    }
+
+    iterator insert(const_iterator position, value_type&& x) {
+        return this->emplace_hint(position, static_cast<value_type&&>(x));
+    }
+
+    template<class InputIterator,
+             class = typename std::enable_if<flatmap_detail::qualifies_as_input_iterator<InputIterator>::value>::type>
+    void insert(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) {
+            this->emplace(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> il) {
+        this->insert(il.begin(), il.end());
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const Key& k, Args&&... args) {
+        size_t i = this->lower_bound_index(k);
+        if (i == size_ || compare_(k, key_at(i))) {
+            this->insert_at(i, Key(k), Mapped(static_cast<Args&&>(args)...));
+            return {make_iterator_at(i), true};
+        }
+        return {make_iterator_at(i), false};
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(Key&& k, Args&&... args) {
+        size_t i = this->lower_bound_index(k);
+        if (i == size_ || compare_(k, key_at(i))) {
+            this->insert_at(i, static_cast<Key&&>(k), Mapped(static_cast<Args&&>(args)...));
+            return {make_iterator_at(i), true};
+        }
+        return {make_iterator_at(i), false};
+    }
+
+    template<class K, class... Args,
+             class Compare_ = Compare, class = typename Compare_::is_transparent,
+             class = typename std::enable_if<flatmap_detail::is_transparent_key_arg<K, Key, iterator, const_iterator>::value>::type>
+    std::pair<iterator, bool> try_emplace(K&& x, Args&&... args) {
+        size_t i = this->lower_bound_index(x);
+        if (i == size_ || compare_(x, key_at(i))) {
+            this->insert_at(i, Key(static_cast<K&&>(x)), Mapped(static_cast<Args&&>(args)...));
+            return {make_iterator_at(i), true};
+        }
+        return {make_iterator_at(i), false};
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const Key& k, M&& obj) {
+        static_assert(std::is_assignable<Mapped&, M>::value, "");
+        auto result = try_emplace(k, static_cast<M&&>(obj));
+        if (!result.second) {
+            result.first->second = static_cast<M&&>(obj);
+        }
+        return result;
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(Key&& k, M&& obj) {
+        static_assert(std::is_assignable<Mapped&, M>::value, "");
+        auto result = try_emplace(static_cast<Key&&>(k), static_cast<M&&>(obj));
+        if (!result.second) {
+            result.first->second = static_cast<M&&>(obj);
+        }
+        return result;
+    }
+
+    template<class K, class M,
+             class Compare_ = Compare, class = typename Compare_::is_transparent,
+             class = typename std::enable_if<flatmap_detail::is_transparent_key_arg<K, Key, iterator, const_iterator>::value>::type>
+    std::pair<iterator, bool> insert_or_assign(K&& x, M&& obj) {
+        static_assert(std::is_assignable<Mapped&, M>::value, "");
+        auto result = try_emplace(static_cast<K&&>(x), static_cast<M&&>(obj));
+        if (!result.second) {
+            result.first->second = static_cast<M&&>(obj);
+        }
+        return result;
+    }
+
+    iterator erase(iterator position) {
+        size_t i = position.private_impl_getkey().index();
+        this->erase_at(i);
+        return make_iterator_at(i);
+    }
+
+    iterator erase(const_iterator position) {
+        size_t i = position.private_impl_getkey().index();
+        this->erase_at(i);
+        return make_iterator_at(i);
+    }
+
+    size_type erase(const Key& k) {
+        auto it = this->find(k);
+        if (it != this->end()) {
+            this->erase(it);
+            return 1;
+        }
+        return 0;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        size_t i = first.private_impl_getkey().index();
+        size_t j = last.private_impl_getkey().index();
+        this->erase_at(i, j - i);
+        return make_iterator_at(i);
+    }
+
+    void swap(interleaved_flat_map& m) noexcept
+#if defined(__cpp_lib_is_swappable)
+        (std::is_nothrow_swappable<Compare>::value)
+#endif
+    {
+        using std::swap;
+        swap(compare_, m.compare_);
+        swap(blocks_, m.blocks_);
+        swap(size_, m.size_);
+    }
+
+    friend void swap(interleaved_flat_map& a, interleaved_flat_map& b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    void clear() noexcept {
+        blocks_.clear();
+        size_ = 0;
+    }
+
+    key_compare key_comp() const {
+        return compare_;
+    }
+
+    iterator find(const Key& k) {
+        size_t i = this->lower_bound_index(k);
+        return (i == size_ || compare_(k, key_at(i))) ? end() : make_iterator_at(i);
+    }
+
+    const_iterator find(const Key& k) const {
+        size_t i = this->lower_bound_index(k);
+        return (i == size_ || compare_(k, key_at(i))) ? end() : make_iterator_at(i);
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    iterator find(const K& x) {
+        size_t i = this->lower_bound_index(x);
+        return (i == size_ || compare_(x, key_at(i))) ? end() : make_iterator_at(i);
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    const_iterator find(const K& x) const {
+        size_t i = this->lower_bound_index(x);
+        return (i == size_ || compare_(x, key_at(i))) ? end() : make_iterator_at(i);
+    }
+
+    size_type count(const Key& k) const {
+        return this->contains(k) ? 1 : 0;
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    size_type count(const K& x) const {
+        return this->contains(x) ? 1 : 0;
+    }
+
+    bool contains(const Key& k) const {
+        return this->find(k) != this->end();
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    bool contains(const K& x) const {
+        return this->find(x) != this->end();
+    }
+
+    iterator lower_bound(const Key& k) { return make_iterator_at(this->lower_bound_index(k)); }
+    const_iterator lower_bound(const Key& k) const { return make_iterator_at(this->lower_bound_index(k)); }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    iterator lower_bound(const K& x) { return make_iterator_at(this->lower_bound_index(x)); }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    const_iterator lower_bound(const K& x) const { return make_iterator_at(this->lower_bound_index(x)); }
+
+    iterator upper_bound(const Key& k) { return make_iterator_at(this->upper_bound_index(k)); }
+    const_iterator upper_bound(const Key& k) const { return make_iterator_at(this->upper_bound_index(k)); }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    iterator upper_bound(const K& x) { return make_iterator_at(this->upper_bound_index(x)); }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    const_iterator upper_bound(const K& x) const { return make_iterator_at(this->upper_bound_index(x)); }
+
+    // The keys are unique, so the range holds at most the element at lower_bound.
+    std::pair<iterator, iterator> equal_range(const Key& k) {
+        size_t i = this->lower_bound_index(k);
+        return {make_iterator_at(i), make_iterator_at(i + this->key_matches_at(i, k))};
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Key& k) const {
+        size_t i = this->lower_bound_index(k);
+        return {make_iterator_at(i), make_iterator_at(i + this->key_matches_at(i, k))};
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    std::pair<iterator, iterator> equal_range(const K& x) {
+        size_t i = this->lower_bound_index(x);
+        return {make_iterator_at(i), make_iterator_at(i + this->key_matches_at(i, x))};
+    }
+
+    template<class K,
+             class Compare_ = Compare, class = typename Compare_::is_transparent>
+    std::pair<const_iterator, const_iterator> equal_range(const K& x) const {
+        size_t i = this->lower_bound_index(x);
+        return {make_iterator_at(i), make_iterator_at(i + this->key_matches_at(i, x))};
+    }
+
+    friend bool operator==(const interleaved_flat_map& a, const interleaved_flat_map& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+    friend bool operator!=(const interleaved_flat_map& a, const interleaved_flat_map& b) {
+        return !(a == b);
+    }
+
+private:
+    const Key& key_at(size_t i) const { return blocks_[i / BlockSize].keys[i % BlockSize]; }
+    Key& key_at(size_t i) { return blocks_[i / BlockSize].keys[i % BlockSize]; }
+    Mapped& mapped_at(size_t i) { return blocks_[i / BlockSize].values[i % BlockSize]; }
+
+    iterator make_iterator_at(size_t i) {
+        return flatmap_detail::make_iterator(key_iterator(blocks_.data(), i), mapped_iterator(blocks_.data(), i));
+    }
+
+    const_iterator make_iterator_at(size_t i) const {
+        return flatmap_detail::make_iterator(key_iterator(blocks_.data(), i), const_mapped_iterator(blocks_.data(), i));
+    }
+
+    // Returns the last block whose first key satisfies pred, or the first block
+    // if none does. Each step touches one block, not one key per cache line.
+    template<class Pred>
+    const block_type *find_block(Pred pred) const {
+        const block_type *base = blocks_.data();
+        size_t n = blocks_.size();
+        while (n > 1) {
+            size_t half = n / 2;
+            base = pred(base[half].keys[0]) ? base + half : base;
+            n -= half;
+        }
+        return base;
+    }
+
+    template<class Pred>
+    size_t block_partition_point(Pred pred) const {
+        if (size_ == 0) {
+            return 0;
+        }
+        const block_type *base = this->find_block(pred);
+        size_t b = size_t(base - blocks_.data());
+        size_t m = (std::min)(BlockSize, size_ - b * BlockSize);
+        return b * BlockSize + size_t(std::partition_point(base->keys, base->keys + m, pred) - base->keys);
+    }
+
+    size_t lower_bound_index(const Key& k) const {
+        return this->lower_bound_index_impl(k, flatmap_detail::is_branchless_searchable<Key, Compare, std::vector<Key>>());
+    }
+
+    size_t lower_bound_index_impl(const Key& k, std::false_type) const {
+        return this->block_partition_point([&](const Key& elt) { return bool(compare_(elt, k)); });
+    }
+
+    size_t lower_bound_index_impl(const Key& k, std::true_type) const {
+        if (size_ == 0) {
+            return 0;
+        }
+        const block_type *base = this->find_block([&](const Key& elt) { return elt < k; });
+        size_t b = size_t(base - blocks_.data());
+        size_t m = (std::min)(BlockSize, size_ - b * BlockSize);
+        return b * BlockSize + flatmap_detail::count_less(base->keys, m, k);
+    }
+
+    template<class K>
+    size_t lower_bound_index(const K& x) const {
+        return this->block_partition_point([&](const Key& elt) { return bool(compare_(elt, x)); });
+    }
+
+    template<class K>
+    size_t upper_bound_index(const K& x) const {
+        return this->block_partition_point([&](const Key& elt) { return !bool(compare_(x, elt)); });
+    }
+
+    // Returns lower_bound_index(x), without searching if x belongs immediately before index h.
+    template<class K>
+    size_t lower_bound_index_near(size_t h, const K& x) const {
+        bool hint_is_correct = (h == size_ || compare_(x, key_at(h))) && (h == 0 || compare_(key_at(h - 1), x));
+        return hint_is_correct ? h : this->lower_bound_index(x);
+    }
+
+    template<class K>
+    bool key_matches_at(size_t i, const K& x) const {
+        return i != size_ && !bool(compare_(x, key_at(i)));
+    }
+
+    std::pair<iterator, bool> insert_or_find_impl(Key&& k, Mapped&& m) {
+        size_t i = this->lower_bound_index(k);
+        if (i == size_ || compare_(k, key_at(i))) {
+            this->insert_at(i, static_cast<Key&&>(k), static_cast<Mapped&&>(m));
+            return {make_iterator_at(i), true};
+        }
+        return {make_iterator_at(i), false};
+    }
+
+    void assign_sorted_impl(std::vector<std::pair<Key, Mapped>>& v) {
+        blocks_.resize((v.size() + BlockSize - 1) / BlockSize);
+        for (size_t i = 0; i < v.size(); ++i) {
+            key_at(i) = static_cast<Key&&>(v[i].first);
+            mapped_at(i) = static_cast<Mapped&&>(v[i].second);
+        }
+        size_ = v.size();
+    }
+
+    // insert_at and erase_at shift elements by move-assignment. If one of those
+    // throws, an element has already been overwritten and can't be restored,
+    // so, like flat_map, they clear the map rather than leave it out of order.
+    // Growing blocks_ happens first, and leaves the map unchanged if it throws.
+    void insert_at(size_t i, Key&& k, Mapped&& m) {
+        if (size_ == capacity()) {
+            blocks_.emplace_back();
+        }
+        flatmap_detail::InvariantRestoringGuard<interleaved_flat_map> guard(this);
+        for (size_t j = size_; j > i; --j) {
+            key_at(j) = static_cast<Key&&>(key_at(j - 1));
+            mapped_at(j) = static_cast<Mapped&&>(mapped_at(j - 1));
+        }
+        key_at(i) = static_cast<Key&&>(k);
+        mapped_at(i) = static_cast<Mapped&&>(m);
+        size_ += 1;
+        guard.complete();
+    }
+
+    void erase_at(size_t i, size_t n = 1) {
+        if (n == 0) {
+            return;
+        }
+        flatmap_detail::InvariantRestoringGuard<interleaved_flat_map> guard(this);
+        for (size_t j = i + n; j < size_; ++j) {
+            key_at(j - n) = static_cast<Key&&>(key_at(j));
+            mapped_at(j - n) = static_cast<Mapped&&>(mapped_at(j));
+        }
+        size_ -= n;
+        for (size_t j = size_; j < size_ + n && j % BlockSize != 0; ++j) {
+            key_at(j) = Key();
+            mapped_at(j) = Mapped();
+        }
+        blocks_.resize((size_ + BlockSize - 1) / BlockSize);
+        guard.complete();
+    }
+
+    std::vector<block_type> blocks_;
+    size_t size_;
+    Compare compare_;
+};
+
 } // namespace sg14
@@ -31,9 +31,13 @@
 
 #include <stddef.h>
 #include <algorithm>
+#include <exception>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #if __cplusplus >= 202002L
@@ -42,6 +46,29 @@
 #include <ranges>
 #endif // __cplusplus >= 202002L
 
+#ifndef SG14_FLAT_SET_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define SG14_FLAT_SET_EXCEPTIONS 1
+#else
+#define SG14_FLAT_SET_EXCEPTIONS 0
+#endif
+#endif
+
+#ifndef SG14_FLAT_SET_USE_SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SG14_FLAT_SET_USE_SSE2 1
+#else
+#define SG14_FLAT_SET_USE_SSE2 0
+#endif
+#endif
+
+#if SG14_FLAT_SET_USE_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#endif
+
 namespace sg14 {
 
 namespace flatset_detail {
@@ -102,6 +129,197 @@ namespace flatset_detail {
         return dfirst;
     }
 
+    // Returns the end of the run that begins at first: the longest prefix of
+    // [first, last) that is either non-descending or non-ascending.
+    // A non-ascending run is reversed in place.
+    template<class It, class Compare>
+    It find_run(It first, It last, Compare& less) {
+        // Skip past any leading equal elements before deciding the run's direction.
+        It it = first + 1;
+        while (it != last && !less(*it, *(it - 1)) && !less(*(it - 1), *it)) ++it;
+        if (it != last && less(*it, *(it - 1))) {
+            ++it;
+            while (it != last && !less(*(it - 1), *it)) ++it;
+            std::reverse(first, it);
+        } else {
+            while (it != last && !less(*it, *(it - 1))) ++it;
+        }
+        return it;
+    }
+
+    // Sorts input that is mostly in order already. Elements that are out of
+    // order are set aside, sorted separately, and merged back in; this costs
+    // O(n + m log m) for m misplaced elements. If m grows too large,
+    // falls back to sorting everything from scratch.
+    template<class Compare, class KeyContainer>
+    void sort_with_outliers(Compare& less, KeyContainer& c) {
+        auto first = c.begin();
+        size_t n = c.size();
+        std::vector<typename KeyContainer::value_type> tmp;
+        constexpr size_t MaxPop = 8;
+        size_t w = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (w != 0 && less(*(first + i), *(first + (w-1)))) {
+                // Either this element is out of order, or the last few we kept are.
+                // If the next element is also less than the last one we kept,
+                // assume the latter, as long as there are only a few of them.
+                size_t j = 1;
+                while (j < w && j <= MaxPop && less(*(first + i), *(first + (w-1-j)))) ++j;
+                if (j <= MaxPop && i + 1 != n && less(*(first + (i+1)), *(first + (w-1)))) {
+                    for (; j != 0; --j) {
+                        --w;
+                        tmp.push_back(std::move(*(first + w)));
+                    }
+                } else {
+                    tmp.push_back(std::move(*(first + i)));
+                    if (tmp.size() > n / 8) {
+                        std::move(tmp.begin(), tmp.end(), first + w);
+                        std::sort(first, first + n, less);
+                        return;
+                    }
+                    continue;
+                }
+            }
+            if (w != i) {
+                *(first + w) = std::move(*(first + i));
+            }
+            ++w;
+        }
+        std::sort(tmp.begin(), tmp.end(), less);
+        // Merge backward, so that each element moves at most once.
+        size_t j = tmp.size();
+        while (j != 0) {
+            --n;
+            if (w != 0 && less(tmp[j-1], *(first + (w-1)))) {
+                --w;
+                *(first + n) = std::move(*(first + w));
+            } else {
+                --j;
+                *(first + n) = std::move(tmp[j]);
+            }
+        }
+    }
+
+    // Input that consists of a few sorted (or reverse-sorted) runs is
+    // sorted by merging those runs, in O(n log r) time for r runs;
+    // already-sorted input costs only n-1 comparisons.
+    template<class Compare, class KeyContainer>
+    void natural_sort(Compare& less, KeyContainer& c) {
+        constexpr size_t MaxRuns = 64;
+        auto first = c.begin();
+        size_t n = c.size();
+        std::vector<size_t> runs;
+        size_t i = 0;
+        while (i != n && runs.size() != MaxRuns) {
+            runs.push_back(i);
+            i = flatset_detail::find_run(first + i, first + n, less) - first;
+        }
+        if (i != n) {
+            flatset_detail::sort_with_outliers(less, c);
+            return;
+        } else if (runs.size() <= 1) {
+            return;
+        }
+        runs.push_back(n);
+        while (runs.size() > 2) {
+            size_t w = 0;
+            size_t r = 0;
+            for (; r + 2 < runs.size(); r += 2) {
+                std::inplace_merge(first + runs[r], first + runs[r+1], first + runs[r+2], less);
+                runs[w++] = runs[r];
+            }
+            if (r + 1 < runs.size()) {
+                runs[w++] = runs[r];
+            }
+            runs[w++] = n;
+            runs.resize(w);
+        }
+    }
+
+    struct thread_joiner {
+        std::vector<std::thread>& threads_;
+        ~thread_joiner() {
+            for (auto& t : threads_) {
+                t.join();
+            }
+        }
+    };
+
+    // Calls f(0), f(1), ..., f(count-1) concurrently, each on its own thread
+    // (f(0) on the calling thread), and waits for them all to finish.
+    // If any call throws, the first exception is rethrown once all the threads have finished.
+    template<class F>
+    void parallel_for(size_t count, const F& f) {
+#if SG14_FLAT_SET_EXCEPTIONS
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto run = [&](size_t i) {
+            try {
+                f(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(error_mutex);
+                if (error == nullptr) {
+                    error = std::current_exception();
+                }
+            }
+        };
+#else
+        const F& run = f;
+#endif
+        {
+            std::vector<std::thread> threads;
+            threads.reserve(count);
+            thread_joiner joiner{threads};
+            for (size_t i = 1; i < count; ++i) {
+                threads.emplace_back(run, i);
+            }
+            run(0);
+        }
+#if SG14_FLAT_SET_EXCEPTIONS
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+#endif
+    }
+
+    // Splits the input into one chunk per thread and sorts the chunks concurrently;
+    // then merges pairs of adjacent chunks concurrently, until one chunk remains.
+    // std::sort and std::inplace_merge take the comparator by value,
+    // so each thread works with its own copy of it.
+    template<class Compare, class KeyContainer>
+    void parallel_sort(const Compare& less, KeyContainer& c, size_t threads) {
+        constexpr size_t MinPerThread = 4096;
+        size_t n = c.size();
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        threads = (std::min)(threads, n / MinPerThread);
+        if (threads <= 1) {
+            Compare comp = less;
+            flatset_detail::natural_sort(comp, c);
+            return;
+        }
+        auto first = c.begin();
+        std::vector<size_t> bounds(threads + 1);
+        for (size_t i = 0; i <= threads; ++i) {
+            bounds[i] = n / threads * i + (std::min)(i, n % threads);
+        }
+        flatset_detail::parallel_for(threads, [&](size_t t) {
+            std::sort(first + bounds[t], first + bounds[t+1], less);
+        });
+        while (bounds.size() > 2) {
+            flatset_detail::parallel_for((bounds.size() - 1) / 2, [&](size_t p) {
+                std::inplace_merge(first + bounds[2*p], first + bounds[2*p+1], first + bounds[2*p+2], less);
+            });
+            size_t w = 0;
+            for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+                bounds[w++] = bounds[r];
+            }
+            bounds[w++] = n;
+            bounds.resize(w);
+        }
+    }
+
     template<class FS>
     struct InvariantRestoringGuard {
         FS *self_;
@@ -132,6 +350,176 @@ namespace flatset_detail {
     template<class It>
     using qualifies_as_input_iterator = std::integral_constant<bool, !std::is_integral<It>::value>;
 
+    // Lookups on a container of arithmetic keys ordered by std::less can skip
+    // the comparator and binary-search the contiguous key array directly.
+    template<class KeyContainer, class = void>
+    struct has_contiguous_data : std::false_type {};
+    template<class KeyContainer>
+    struct has_contiguous_data<KeyContainer, void_t<decltype(std::declval<const KeyContainer&>().data())>> : std::is_same<
+        decltype(std::declval<const KeyContainer&>().data()),
+        const typename KeyContainer::value_type*
+    > {};
+
+    template<class Key, class Compare, class KeyContainer>
+    using is_branchless_searchable = std::integral_constant<bool,
+        std::is_arithmetic<Key>::value &&
+        (std::is_same<Compare, std::less<Key>>::value || std::is_same<Compare, std::less<>>::value) &&
+        std::is_same<typename KeyContainer::value_type, Key>::value &&
+        has_contiguous_data<KeyContainer>::value
+    >;
+
+    // Returns the number of elements in [p, p+n) that are less than value.
+    template<class T>
+    size_t count_less(const T *p, size_t n, const T& value) {
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i) {
+            count += (p[i] < value);
+        }
+        return count;
+    }
+
+#if SG14_FLAT_SET_USE_SSE2
+    // Signed compares work for unsigned keys too, once both sides have their top bit flipped.
+    template<class T>
+    size_t count_less_simd(const T *p, size_t n, T value) {
+        const int bias = std::is_signed<T>::value ? 0 : int(0x80000000u);
+        size_t i = 0;
+#if defined(__AVX2__)
+        __m256i bias8 = _mm256_set1_epi32(bias);
+        __m256i value8 = _mm256_xor_si256(_mm256_set1_epi32(int(value)), bias8);
+        __m256i acc8 = _mm256_setzero_si256();
+        for (; i + 8 <= n; i += 8) {
+            __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), bias8);
+            acc8 = _mm256_sub_epi32(acc8, _mm256_cmpgt_epi32(value8, x));
+        }
+        __m128i acc = _mm_add_epi32(_mm256_castsi256_si128(acc8), _mm256_extracti128_si256(acc8, 1));
+#else
+        __m128i acc = _mm_setzero_si128();
+#endif
+        __m128i bias4 = _mm_set1_epi32(bias);
+        __m128i value4 = _mm_xor_si128(_mm_set1_epi32(int(value)), bias4);
+        for (; i + 4 <= n; i += 4) {
+            __m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), bias4);
+            acc = _mm_sub_epi32(acc, _mm_cmplt_epi32(x, value4));
+        }
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+        size_t count = size_t(_mm_cvtsi128_si32(acc));
+        for (; i < n; ++i) {
+            count += (p[i] < value);
+        }
+        return count;
+    }
+    inline size_t count_less(const int *p, size_t n, const int& value) {
+        return flatset_detail::count_less_simd(p, n, value);
+    }
+    inline size_t count_less(const unsigned *p, size_t n, const unsigned& value) {
+        return flatset_detail::count_less_simd(p, n, value);
+    }
+#endif // SG14_FLAT_SET_USE_SSE2
+
+    // Equivalent to std::lower_bound(first, first+n, value), but the loop
+    // contains no data-dependent branches: each step halves the range with a
+    // conditional move, and the last few candidates are compared all at once.
+    template<class T>
+    const T *branchless_lower_bound(const T *first, size_t n, const T& value) {
+        while (n > 16) {
+            size_t half = n / 2;
+            first = (first[half] < value) ? first + half : first;
+            n -= half;
+        }
+        return first + flatset_detail::count_less(first, n, value);
+    }
+
+    inline void prefetch(const void *p) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#elif SG14_FLAT_SET_USE_SSE2
+        _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+        (void)p;
+#endif
+    }
+
+    // Proxy iterators (such as vector<bool>'s) have no address to prefetch.
+    template<class It>
+    void prefetch_element(It it, std::true_type) { flatset_detail::prefetch(std::addressof(*it)); }
+    template<class It>
+    void prefetch_element(It, std::false_type) {}
+    template<class It>
+    void prefetch_element(It it) {
+        flatset_detail::prefetch_element(it, std::is_lvalue_reference<decltype(*it)>());
+    }
+
+    // Heterogeneous queries might not be comparable to each other in the same way.
+    template<class ForwardIt, class Compare>
+    bool queries_are_sorted(ForwardIt first, ForwardIt last, const Compare& compare, std::true_type) {
+        return std::is_sorted(first, last, compare);
+    }
+    template<class ForwardIt, class Compare>
+    bool queries_are_sorted(ForwardIt, ForwardIt, const Compare&, std::false_type) {
+        return false;
+    }
+
+    // Calls emit(q, i) for each query q in [qfirst, qlast), in order, where
+    // i is the index of the lower bound of q in the sorted range [kfirst, kfirst+n).
+    // Sorted queries are resolved by galloping forward from the previous answer.
+    // Otherwise, the queries are binary-searched in groups, one level at a time,
+    // so that the cache misses of a whole group are in flight at once.
+    template<class KeyIt, class Compare, class ForwardIt, class F>
+    void lower_bound_many(KeyIt kfirst, size_t n, const Compare& compare, ForwardIt qfirst, ForwardIt qlast, F&& emit) {
+        using QueryIsKey = std::is_same<
+            typename std::iterator_traits<ForwardIt>::value_type,
+            typename std::iterator_traits<KeyIt>::value_type
+        >;
+        if (flatset_detail::queries_are_sorted(qfirst, qlast, compare, QueryIsKey())) {
+            size_t prev = 0;
+            for (; qfirst != qlast; ++qfirst) {
+                size_t lo = prev;
+                size_t hi = prev;
+                size_t step = 1;
+                while (hi < n && bool(compare(kfirst[hi], *qfirst))) {
+                    lo = hi + 1;
+                    hi += step;
+                    step *= 2;
+                }
+                auto kit = std::partition_point(kfirst + lo, kfirst + (std::min)(hi, n), [&](const auto& elt) {
+                    return bool(compare(elt, *qfirst));
+                });
+                prev = size_t(kit - kfirst);
+                emit(*qfirst, prev);
+            }
+            return;
+        }
+        constexpr size_t G = 8;
+        ForwardIt queries[G];
+        size_t bases[G];
+        while (qfirst != qlast) {
+            size_t m = 0;
+            for (; m < G && qfirst != qlast; ++m, ++qfirst) {
+                queries[m] = qfirst;
+                bases[m] = 0;
+            }
+            size_t len = n;
+            while (len > 1) {
+                size_t half = len / 2;
+                size_t next_half = (len - half) / 2;
+                for (size_t j = 0; j < m; ++j) {
+                    flatset_detail::prefetch_element(kfirst + (bases[j] + next_half));
+                    flatset_detail::prefetch_element(kfirst + (bases[j] + half + next_half));
+                }
+                for (size_t j = 0; j < m; ++j) {
+                    bases[j] = bool(compare(kfirst[bases[j] + half], *queries[j])) ? bases[j] + half : bases[j];
+                }
+                len -= half;
+            }
+            for (size_t j = 0; j < m; ++j) {
+                size_t i = bases[j] + size_t(len == 1 && bool(compare(kfirst[bases[j]], *queries[j])));
+                emit(*queries[j], i);
+            }
+        }
+    }
+
 } // namespace flatset_detail
 
 #ifndef SG14_HAS_SORTED_UNIQUE
@@ -146,6 +534,20 @@ constexpr sorted_unique_t sorted_unique {};
 
 #endif // SG14_HAS_SORTED_UNIQUE
 
+#ifndef SG14_HAS_SORT_THREADS
+#define SG14_HAS_SORT_THREADS
+
+// Passed to a constructor or to replace() to sort the input on that many
+// threads. Zero means std::thread::hardware_concurrency().
+struct sort_threads {
+    explicit sort_threads(size_t count) : count_(count) {}
+    size_t count() const { return count_; }
+private:
+    size_t count_;
+};
+
+#endif // SG14_HAS_SORT_THREADS
+
 template<
     class Key,
     class Compare = std::less<Key>,
@@ -272,6 +674,13 @@ public:
     flat_set(InputIterator first, InputIterator last, const Alloc& a)
         : flat_set(first, last, Compare(), a) {}
 
+    template<class InputIterator>
+    flat_set(sort_threads threads, InputIterator first, InputIterator last, const Compare& comp = Compare())
+        : c_(first, last), compare_(comp)
+    {
+        this->sort_and_unique_impl(threads);
+    }
+
     template<class InputIterator>
     flat_set(sorted_unique_t, InputIterator first, InputIterator last, const Compare& comp = Compare())
         : c_(first, last), compare_(comp) {}
@@ -499,6 +908,13 @@ public:
         this->sort_and_unique_impl();
     }
 
+    void replace(sort_threads threads, KeyContainer ctr) {
+        flatset_detail::InvariantRestoringGuard<flat_set> guard(this);
+        c_ = static_cast<KeyContainer&&>(ctr);
+        this->sort_and_unique_impl(threads);
+        guard.complete();
+    }
+
     void replace(sorted_unique_t, KeyContainer ctr) {
         c_ = static_cast<KeyContainer&&>(ctr);
     }
@@ -605,16 +1021,45 @@ public:
         return this->find(x) != this->end();
     }
 
-    iterator lower_bound(const Key& t) {
-        return std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
-            return bool(compare_(elt, t));
+    // Looks up each key in [first, last), and writes to result the iterator
+    // that find would have returned for it. This is faster than calling find
+    // in a loop, especially when [first, last) is sorted.
+    template<class ForwardIterator, class OutputIterator>
+    OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator result) {
+        flatset_detail::lower_bound_many(c_.cbegin(), c_.size(), compare_, first, last, [&](const auto& k, size_t i) {
+            bool found = (i != c_.size()) && !bool(compare_(k, c_[i]));
+            *result = found ? this->begin() + i : this->end();
+            ++result;
         });
+        return result;
     }
 
-    const_iterator lower_bound(const Key& t) const {
-        return std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
-            return bool(compare_(elt, t));
+    template<class ForwardIterator, class OutputIterator>
+    OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator result) const {
+        flatset_detail::lower_bound_many(c_.cbegin(), c_.size(), compare_, first, last, [&](const auto& k, size_t i) {
+            bool found = (i != c_.size()) && !bool(compare_(k, c_[i]));
+            *result = found ? this->begin() + i : this->end();
+            ++result;
+        });
+        return result;
+    }
+
+    // Writes to result whether each key in [first, last) is present.
+    template<class ForwardIterator, class OutputIterator>
+    OutputIterator contains_many(ForwardIterator first, ForwardIterator last, OutputIterator result) const {
+        flatset_detail::lower_bound_many(c_.cbegin(), c_.size(), compare_, first, last, [&](const auto& k, size_t i) {
+            *result = (i != c_.size()) && !bool(compare_(k, c_[i]));
+            ++result;
         });
+        return result;
+    }
+
+    iterator lower_bound(const Key& t) {
+        return this->begin() + this->lower_bound_index(t);
+    }
+
+    const_iterator lower_bound(const Key& t) const {
+        return this->begin() + this->lower_bound_index(t);
     }
 
     template<class K,
@@ -662,9 +1107,7 @@ public:
     }
 
     std::pair<iterator, iterator> equal_range(const Key& t) {
-        auto lo = std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
-            return bool(compare_(elt, t));
-        });
+        auto lo = this->begin() + this->lower_bound_index(t);
         auto hi = std::partition_point(lo, this->end(), [&](const Key& elt) {
             return !bool(compare_(t, elt));
         });
@@ -672,9 +1115,7 @@ public:
     }
 
     std::pair<const_iterator, const_iterator> equal_range(const Key& t) const {
-        auto lo = std::partition_point(this->begin(), this->end(), [&](const Key& elt) {
-            return bool(compare_(elt, t));
-        });
+        auto lo = this->begin() + this->lower_bound_index(t);
         auto hi = std::partition_point(lo, this->end(), [&](const Key& elt) {
             return !bool(compare_(t, elt));
         });
@@ -725,11 +1166,34 @@ public:
 
 private:
     void sort_and_unique_impl() {
-        std::sort(c_.begin(), c_.end(), compare_);
+        flatset_detail::natural_sort(compare_, c_);
+        auto it = flatset_detail::unique_helper(c_.begin(), c_.end(), compare_);
+        c_.erase(it, c_.end());
+    }
+
+    void sort_and_unique_impl(sort_threads threads) {
+        flatset_detail::parallel_sort(compare_, c_, threads.count());
         auto it = flatset_detail::unique_helper(c_.begin(), c_.end(), compare_);
         c_.erase(it, c_.end());
     }
 
+    size_t lower_bound_index(const Key& t) const {
+        using UseBranchless = flatset_detail::is_branchless_searchable<Key, Compare, KeyContainer>;
+        return this->lower_bound_index_impl(t, UseBranchless());
+    }
+
+    size_t lower_bound_index_impl(const Key& t, std::false_type) const {
+        auto it = std::partition_point(c_.begin(), c_.end(), [&](const Key& elt) {
+            return bool(compare_(elt, t));
+        });
+        return it - c_.begin();
+    }
+
+    size_t lower_bound_index_impl(const Key& t, std::true_type) const {
+        const Key *first = c_.data();
+        return flatset_detail::branchless_lower_bound(first, c_.size(), t) - first;
+    }
+
     KeyContainer c_;
     Compare compare_;
 };
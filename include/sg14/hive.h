@@ -45,13 +45,17 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <exception>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #if __cplusplus >= 202002L
 #include <compare>
@@ -116,12 +120,19 @@ namespace hive_priority {
     };
 }
 
+template <class T, class allocator_type = std::allocator<T>, class priority = sg14::hive_priority::performance>
+class hive_group_pool;
+
 template <class T, class allocator_type = std::allocator<T>, class priority = sg14::hive_priority::performance>
 class hive {
     template<bool IsConst> class hive_iterator;
     template<bool IsConst> class hive_reverse_iterator;
+    template<bool IsConst> class hive_segment;
+    template<bool IsConst> class hive_segment_iterator;
+    template<bool IsConst> class hive_segment_range;
     friend class hive_iterator<false>;
     friend class hive_iterator<true>;
+    friend class hive_group_pool<T, allocator_type, priority>;
 
     using skipfield_type = typename priority::skipfield_type;
     using AllocTraits = std::allocator_traits<allocator_type>;
@@ -138,6 +149,8 @@ public:
     using const_iterator = hive_iterator<true>;
     using reverse_iterator = hive_reverse_iterator<false>;
     using const_reverse_iterator = hive_reverse_iterator<true>;
+    using segment = hive_segment<false>;
+    using const_segment = hive_segment<true>;
 
 private:
     inline auto make_value_callback(size_type, const T& value) {
@@ -720,6 +733,119 @@ private:
 #endif
     }; // hive_reverse_iterator
 
+    // A segment is one group of the hive: extent() cells, of which size() are live.
+    // In skipfield(), the first and the last cell of each run of erased cells hold
+    // the length of the run, and every live cell holds zero; the other erased cells
+    // hold unspecified values. for_each_run calls f(first, last) for each run of
+    // live cells; when is_packed(), that is the single run [0, extent()).
+    // for_each visits each live cell in a plain loop that the compiler can vectorize.
+    template <bool IsConst>
+    class hive_segment {
+        GroupPtr group_ = GroupPtr();
+
+        friend class hive;
+        friend class hive_segment<!IsConst>;
+        friend class hive_segment_iterator<IsConst>;
+        explicit hive_segment(GroupPtr g) : group_(g) {}
+
+    public:
+        using skipfield_type = typename hive::skipfield_type;
+        using size_type = typename hive::size_type;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        // The cells are a contiguous array of T, so that data() can be used with
+        // pointer arithmetic, only if T is at least as large as the free-list links.
+        static constexpr bool is_contiguous = (sizeof(overaligned_elt) == sizeof(T));
+
+        hive_segment() = default;
+
+        template<bool IsConst_ = IsConst, class = std::enable_if_t<IsConst_>>
+        hive_segment(const hive_segment<false>& rhs) : group_(rhs.group_) {}
+
+        friend bool operator==(const hive_segment& a, const hive_segment& b) noexcept { return a.group_ == b.group_; }
+        friend bool operator!=(const hive_segment& a, const hive_segment& b) noexcept { return a.group_ != b.group_; }
+
+        inline pointer data() const noexcept { return std::addressof(group_->element(0).t_); }
+        inline reference operator[](size_type i) const noexcept { return group_->element(i).t_; }
+        inline size_type extent() const noexcept { return group_->index_of_last_endpoint(); }
+        inline size_type size() const noexcept { return group_->size; }
+        inline bool is_packed() const noexcept { return group_->is_packed(); }
+        inline const skipfield_type *skipfield() const noexcept { return std::addressof(group_->skipfield(0)); }
+        inline hive_iterator<IsConst> iterator_at(size_type i) const noexcept { return hive_iterator<IsConst>(group_, i); }
+
+        template<class F>
+        void for_each_run(F&& f) const {
+            size_type n = extent();
+            if (is_packed()) {
+                if (n != 0) {
+                    f(size_type(0), n);
+                }
+                return;
+            }
+            const skipfield_type *sf = skipfield();
+            size_type i = sf[0];
+            while (i < n) {
+                size_type j = i + 1;
+                while (j != n && sf[j] == 0) {
+                    ++j;
+                }
+                f(i, j);
+                if (j == n) {
+                    break;
+                }
+                i = j + sf[j];
+            }
+        }
+
+        template<class F>
+        void for_each(F&& f) const {
+            overaligned_elt *elts = std::addressof(group_->element(0));
+            this->for_each_run([&](size_type first, size_type last) {
+                for (size_type i = first; i != last; ++i) {
+                    f(static_cast<reference>(elts[i].t_));
+                }
+            });
+        }
+    }; // class hive_segment
+
+    template <bool IsConst>
+    class hive_segment_iterator {
+        hive_segment<IsConst> seg_;
+
+        friend class hive_segment_range<IsConst>;
+        explicit hive_segment_iterator(GroupPtr g) : seg_(g) {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = hive_segment<IsConst>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const hive_segment<IsConst>*;
+        using reference = const hive_segment<IsConst>&;
+
+        hive_segment_iterator() = default;
+        reference operator*() const noexcept { return seg_; }
+        pointer operator->() const noexcept { return std::addressof(seg_); }
+        hive_segment_iterator& operator++() noexcept { seg_.group_ = seg_.group_->next_group; return *this; }
+        hive_segment_iterator operator++(int) noexcept { auto copy = *this; ++*this; return copy; }
+        friend bool operator==(const hive_segment_iterator& a, const hive_segment_iterator& b) noexcept { return a.seg_ == b.seg_; }
+        friend bool operator!=(const hive_segment_iterator& a, const hive_segment_iterator& b) noexcept { return a.seg_ != b.seg_; }
+    }; // class hive_segment_iterator
+
+    template <bool IsConst>
+    class hive_segment_range {
+        GroupPtr first_ = GroupPtr();
+
+        friend class hive;
+        explicit hive_segment_range(GroupPtr g) : first_(g) {}
+
+    public:
+        using iterator = hive_segment_iterator<IsConst>;
+
+        iterator begin() const noexcept { return iterator(first_); }
+        iterator end() const noexcept { return iterator(GroupPtr()); }
+    }; // class hive_segment_range
+
 public:
     void assert_invariants() const {
 #if SG14_HIVE_DEBUGGING
@@ -879,6 +1005,14 @@ private:
     size_type size_ = 0;
     size_type capacity_ = 0;
     allocator_type allocator_;
+    PtrOf<GroupPtr> group_index_ = PtrOf<GroupPtr>();
+        // Every group this hive owns, used or unused, sorted by address; used by get_iterator().
+        // Kept up to date as groups are allocated, deallocated, and moved between hives,
+        // so that get_iterator() const neither writes nor allocates.
+    size_type group_index_size_ = 0;
+    size_type group_index_capacity_ = 0;
+    hive_group_pool<T, allocator_type, priority> *group_pool_ = nullptr;
+        // If non-null, groups are taken from and returned to this pool instead of the allocator.
 #if !SG14_HIVE_P2596
     skipfield_type min_group_capacity_ = block_capacity_hard_limits().min;
     skipfield_type max_group_capacity_ = block_capacity_hard_limits().max;
@@ -909,6 +1043,9 @@ private:
         unused_groups_tail_ = nullptr;
         size_ = 0;
         capacity_ = 0;
+        group_index_ = nullptr;
+        group_index_size_ = 0;
+        group_index_capacity_ = 0;
     }
 
 #if SG14_HIVE_RELATIONAL_OPERATORS
@@ -925,6 +1062,7 @@ private:
 public:
     hive() = default;
     explicit hive(const allocator_type &alloc) : allocator_(alloc) {}
+    explicit hive(hive_group_pool<T, allocator_type, priority>& pool) : allocator_(pool.get_allocator()), group_pool_(&pool) {}
     hive(const hive& h) : hive(h, std::allocator_traits<allocator_type>::select_on_container_copy_construction(h.allocator_)) {}
 
 #if SG14_HIVE_P2596
@@ -968,7 +1106,11 @@ public:
         unused_groups_(std::move(source.unused_groups_)),
         size_(source.size_),
         capacity_(source.capacity_),
-        allocator_(source.get_allocator())
+        allocator_(source.get_allocator()),
+        group_index_(std::move(source.group_index_)),
+        group_index_size_(source.group_index_size_),
+        group_index_capacity_(source.group_index_capacity_),
+        group_pool_(source.group_pool_)
 #if !SG14_HIVE_P2596
         , min_group_capacity_(source.min_group_capacity_)
         , max_group_capacity_(source.max_group_capacity_)
@@ -1147,13 +1289,130 @@ private:
     };
 
     void allocate_unused_group(size_type cap) {
-        GroupPtr g = GroupAllocHelper::allocate_group(get_allocator(), cap);
+        group_index_reserve(1);
+        GroupPtr g = (group_pool_ != nullptr) ? group_pool_->take(cap) : nullptr;
+        if (g != nullptr) {
+            ::new (cast_pointer<void*>(g)) group(static_cast<skipfield_type>(cap));
+        } else {
+            g = GroupAllocHelper::allocate_group(get_allocator(), cap);
+        }
         unused_groups_push_front(g);
         capacity_ += cap;
+        group_index_insert(g);
     }
 
     inline void deallocate_group(GroupPtr g) {
-        GroupAllocHelper::deallocate_group(get_allocator(), g);
+        group_index_erase(g);
+        if (group_pool_ != nullptr) {
+            group_pool_->give(g);
+        } else {
+            GroupAllocHelper::deallocate_group(get_allocator(), g);
+        }
+    }
+
+    static bool group_address_less(const GroupPtr& a, const GroupPtr& b) {
+        return std::less<const char*>()(cast_pointer<const char*>(a), cast_pointer<const char*>(b));
+    }
+
+    void deallocate_group_index() {
+        auto ia = AllocOf<GroupPtr>(allocator_);
+        for (size_type i = 0; i != group_index_size_; ++i) {
+            std::allocator_traits<AllocOf<GroupPtr>>::destroy(ia, cast_pointer<GroupPtr*>(group_index_ + i));
+        }
+        if (group_index_ != nullptr) {
+            std::allocator_traits<AllocOf<GroupPtr>>::deallocate(ia, group_index_, group_index_capacity_);
+        }
+        group_index_ = nullptr;
+        group_index_size_ = 0;
+        group_index_capacity_ = 0;
+    }
+
+    // Makes room in the group index for n more groups, so that group_index_insert won't throw.
+    void group_index_reserve(size_type n) {
+        size_type needed = group_index_size_ + n;
+        if (needed <= group_index_capacity_) {
+            return;
+        }
+        size_type newcap = (std::max)(needed, 2 * group_index_capacity_);
+        auto ia = AllocOf<GroupPtr>(allocator_);
+        PtrOf<GroupPtr> p = std::allocator_traits<AllocOf<GroupPtr>>::allocate(ia, newcap);
+        GroupPtr *src = cast_pointer<GroupPtr*>(group_index_);
+        GroupPtr *dst = cast_pointer<GroupPtr*>(p);
+        for (size_type i = 0; i != group_index_size_; ++i) {
+            std::allocator_traits<AllocOf<GroupPtr>>::construct(ia, dst + i, src[i]);
+        }
+        size_type size = group_index_size_;
+        deallocate_group_index();
+        group_index_ = p;
+        group_index_size_ = size;
+        group_index_capacity_ = newcap;
+    }
+
+    void group_index_insert(GroupPtr g) noexcept {
+        assert(group_index_size_ < group_index_capacity_);
+        auto ia = AllocOf<GroupPtr>(allocator_);
+        GroupPtr *first = cast_pointer<GroupPtr*>(group_index_);
+        GroupPtr *last = first + group_index_size_;
+        GroupPtr *it = std::upper_bound(first, last, g, group_address_less);
+        std::allocator_traits<AllocOf<GroupPtr>>::construct(ia, last, g);
+        std::rotate(it, last, last + 1);
+        group_index_size_ += 1;
+    }
+
+    // Does nothing if g isn't in the index, e.g. because destroy_all_data has already freed it.
+    void group_index_erase(GroupPtr g) noexcept {
+        auto ia = AllocOf<GroupPtr>(allocator_);
+        GroupPtr *first = cast_pointer<GroupPtr*>(group_index_);
+        GroupPtr *last = first + group_index_size_;
+        GroupPtr *it = std::lower_bound(first, last, g, group_address_less);
+        if (it != last && *it == g) {
+            std::move(it + 1, last, it);
+            std::allocator_traits<AllocOf<GroupPtr>>::destroy(ia, last - 1);
+            group_index_size_ -= 1;
+        }
+    }
+
+    // Merges source's group index into this one, which must have room for it, and empties source's.
+    void group_index_merge_from(hive& source) noexcept {
+        assert(group_index_size_ + source.group_index_size_ <= group_index_capacity_);
+        auto ia = AllocOf<GroupPtr>(allocator_);
+        GroupPtr *first = cast_pointer<GroupPtr*>(group_index_);
+        GroupPtr *src = cast_pointer<GroupPtr*>(source.group_index_);
+        size_type i = group_index_size_;
+        size_type j = source.group_index_size_;
+        for (size_type k = i + j; k != i; ) {
+            --k;
+            std::allocator_traits<AllocOf<GroupPtr>>::construct(ia, first + k, GroupPtr());
+        }
+        // Merge from the back, so that no element is overwritten before it has been moved.
+        for (size_type w = i + j; j != 0; ) {
+            --w;
+            if (i != 0 && group_address_less(src[j - 1], first[i - 1])) {
+                first[w] = first[--i];
+            } else {
+                first[w] = src[--j];
+            }
+        }
+        group_index_size_ += source.group_index_size_;
+        for (size_type k = 0; k != source.group_index_size_; ++k) {
+            std::allocator_traits<AllocOf<GroupPtr>>::destroy(ia, src + k);
+        }
+        source.group_index_size_ = 0;
+    }
+
+    // Returns the iterator to the element at p, which must be an element of this hive.
+    iterator iterator_at_address(const_pointer p) const noexcept {
+        const char *addr = cast_pointer<const char*>(p);
+        const GroupPtr *first = cast_pointer<const GroupPtr*>(group_index_);
+        const GroupPtr *it = std::upper_bound(first, first + group_index_size_, addr, [](const char *a, const GroupPtr& g) {
+            return std::less<const char*>()(a, cast_pointer<const char*>(g));
+        });
+        assert(it != first);
+        GroupPtr g = *(it - 1);
+        size_type idx = (addr - cast_pointer<const char*>(g->addr_of_element(0))) / sizeof(overaligned_elt);
+        assert(idx < g->index_of_last_endpoint());
+        assert(g->skipfield(idx) == 0);
+        return iterator(g, idx);
     }
 
     void unspecialcase_end_group(GroupPtr g) {
@@ -1173,7 +1432,9 @@ private:
     }
 
     void destroy_all_data() {
-        if (GroupPtr g = begin_.group_) {
+        deallocate_group_index();
+        GroupPtr g = (begin_.group_ != nullptr) ? begin_.group_ : unused_groups_;
+        if (begin_.group_ != nullptr) {
             end_.group_->next_group = unused_groups_;
 
             if constexpr (!std::is_trivially_destructible<T>::value) {
@@ -1197,13 +1458,58 @@ private:
                     }
                 }
             }
+        }
 
-            while (g != nullptr) {
-                GroupPtr next = g->next_group;
-                deallocate_group(g);
-                g = next;
+        while (g != nullptr) {
+            GroupPtr next = g->next_group;
+            deallocate_group(g);
+            g = next;
+        }
+    }
+
+    // Constructs an element in the first cell of the head of g's free list.
+    template<class... Args>
+    iterator emplace_into_hole(GroupPtr g, Args&&... args) {
+        assert(!g->is_packed());
+        allocator_type ea = get_allocator();
+        skipfield_type sb = g->free_list_head;
+        assert(sb < g->capacity);
+        auto result = iterator(g, sb);
+        skipfield_type nextsb = g->element(sb).s_.nextlink_;
+        assert(g->element(sb).s_.prevlink_ == std::numeric_limits<skipfield_type>::max());
+        hive_try_rollback([&]() {
+            std::allocator_traits<allocator_type>::construct(ea, result.operator->(), static_cast<Args&&>(args)...);
+        }, [&]() {
+            g->element(sb).s_.prevlink_ = std::numeric_limits<skipfield_type>::max();
+            g->element(sb).s_.nextlink_ = nextsb;
+        });
+        g->size += 1;
+        size_ += 1;
+        if (g == begin_.group_ && sb == 0) {
+            begin_ = result;
+        }
+        skipfield_type old_skipblock_length = std::exchange(g->skipfield(sb), 0);
+        assert(1 <= old_skipblock_length && old_skipblock_length <= g->capacity);
+        skipfield_type new_skipblock_length = (old_skipblock_length - 1);
+        if (new_skipblock_length == 0) {
+            g->free_list_head = nextsb;
+            if (nextsb == std::numeric_limits<skipfield_type>::max()) {
+                remove_from_groups_with_erasures_list(g);
+            } else {
+                g->element(nextsb).s_.prevlink_ = std::numeric_limits<skipfield_type>::max();
+            }
+        } else {
+            g->skipfield(sb + 1) = new_skipblock_length;
+            g->skipfield(sb + old_skipblock_length - 1) = new_skipblock_length;
+            g->free_list_head = sb + 1;
+            g->element(sb + 1).s_.prevlink_ = std::numeric_limits<skipfield_type>::max();
+            g->element(sb + 1).s_.nextlink_ = nextsb;
+            if (nextsb != std::numeric_limits<skipfield_type>::max()) {
+                g->element(nextsb).s_.prevlink_ = sb + 1;
             }
         }
+        assert_invariants();
+        return result;
     }
 
 public:
@@ -1222,45 +1528,7 @@ public:
             assert_invariants();
             return result;
         } else if (groups_with_erasures_ != nullptr) {
-            GroupPtr g = groups_with_erasures_;
-            skipfield_type sb = g->free_list_head;
-            assert(sb < g->capacity);
-            auto result = iterator(g, sb);
-            skipfield_type nextsb = g->element(sb).s_.nextlink_;
-            assert(g->element(sb).s_.prevlink_ == std::numeric_limits<skipfield_type>::max());
-            hive_try_rollback([&]() {
-                std::allocator_traits<allocator_type>::construct(ea, result.operator->(), static_cast<Args&&>(args)...);
-            }, [&]() {
-                g->element(sb).s_.prevlink_ = std::numeric_limits<skipfield_type>::max();
-                g->element(sb).s_.nextlink_ = nextsb;
-            });
-            g->size += 1;
-            size_ += 1;
-            if (g == begin_.group_ && sb == 0) {
-                begin_ = result;
-            }
-            skipfield_type old_skipblock_length = std::exchange(g->skipfield(sb), 0);
-            assert(1 <= old_skipblock_length && old_skipblock_length <= g->capacity);
-            skipfield_type new_skipblock_length = (old_skipblock_length - 1);
-            if (new_skipblock_length == 0) {
-                g->free_list_head = nextsb;
-                if (nextsb == std::numeric_limits<skipfield_type>::max()) {
-                    groups_with_erasures_ = g->next_erasure_;
-                } else {
-                    g->element(nextsb).s_.prevlink_ = std::numeric_limits<skipfield_type>::max();
-                }
-            } else {
-                g->skipfield(sb + 1) = new_skipblock_length;
-                g->skipfield(sb + old_skipblock_length - 1) = new_skipblock_length;
-                g->free_list_head = sb + 1;
-                g->element(sb + 1).s_.prevlink_ = std::numeric_limits<skipfield_type>::max();
-                g->element(sb + 1).s_.nextlink_ = nextsb;
-                if (nextsb != std::numeric_limits<skipfield_type>::max()) {
-                    g->element(nextsb).s_.prevlink_ = sb + 1;
-                }
-            }
-            assert_invariants();
-            return result;
+            return emplace_into_hole(groups_with_erasures_, static_cast<Args&&>(args)...);
         } else {
             if (unused_groups_ == nullptr) {
                 allocate_unused_group(recommend_block_size());
@@ -1680,6 +1948,10 @@ public:
         swap(unused_groups_tail_, source.unused_groups_tail_);
         swap(size_, source.size_);
         swap(capacity_, source.capacity_);
+        swap(group_index_, source.group_index_);
+        swap(group_index_size_, source.group_index_size_);
+        swap(group_index_capacity_, source.group_index_capacity_);
+        swap(group_pool_, source.group_pool_);
 #if !SG14_HIVE_P2596
         swap(min_group_capacity_, source.min_group_capacity_);
         swap(max_group_capacity_, source.max_group_capacity_);
@@ -1737,6 +2009,8 @@ public:
             source.splice(*this);
             swap(source);
         } else {
+            group_index_reserve(source.group_index_size_);
+            group_index_merge_from(source);
             if (source.groups_with_erasures_ != nullptr) {
                 if (groups_with_erasures_ == nullptr) {
                     groups_with_erasures_ = source.groups_with_erasures_;
@@ -2015,6 +2289,108 @@ private:
         }
     }
 
+    // Erases each element for which pred is true, calling pred exactly once per
+    // element, in iteration order. Each group's skipfield and free list are rebuilt
+    // in one linear pass; the groups left empty are unlinked in the same walk, and
+    // the list of groups with erasures is rebuilt at the end.
+    // If pred throws, the elements erased so far stay erased and the exception is rethrown.
+    template<class Pred>
+    size_type bulk_erase_if(Pred& pred) {
+        constexpr skipfield_type no_link = std::numeric_limits<skipfield_type>::max();
+        allocator_type ea = get_allocator();
+        std::exception_ptr error;
+        size_type count = 0;
+        GroupPtr first_kept = nullptr;
+        GroupPtr last_kept = nullptr;
+        GroupPtr erasures = nullptr;
+        for (GroupPtr g = begin_.group_; g != nullptr; ) {
+            GroupPtr next = g->next_group;
+            size_type n = g->index_of_last_endpoint();
+            skipfield_type head = no_link;
+            size_type erased = 0;
+            size_type block_start = n;
+            auto close_block = [&](size_type first, size_type last) {
+                skipfield_type len = static_cast<skipfield_type>(last - first);
+                g->skipfield(first) = len;
+                g->skipfield(last - 1) = len;
+                g->element(first).s_.nextlink_ = head;
+                g->element(first).s_.prevlink_ = no_link;
+                if (head != no_link) {
+                    g->element(head).s_.prevlink_ = static_cast<skipfield_type>(first);
+                }
+                head = static_cast<skipfield_type>(first);
+            };
+            for (size_type i = 0; i != n; ) {
+                if (g->skipfield(i) != 0) {
+                    // An existing run of erased cells; it starts here and has that length.
+                    if (block_start == n) {
+                        block_start = i;
+                    }
+                    i += g->skipfield(i);
+                    continue;
+                }
+                bool doomed = false;
+                if (error == nullptr) {
+                    try {
+                        doomed = static_cast<bool>(pred(*g->element(i).t()));
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                }
+                if (doomed) {
+                    std::allocator_traits<allocator_type>::destroy(ea, g->element(i).t());
+                    ++erased;
+                    if (block_start == n) {
+                        block_start = i;
+                    }
+                } else if (block_start != n) {
+                    close_block(block_start, i);
+                    block_start = n;
+                }
+                ++i;
+            }
+            if (block_start != n) {
+                close_block(block_start, n);
+            }
+            g->free_list_head = head;
+            g->size -= static_cast<skipfield_type>(erased);
+            size_ -= erased;
+            count += erased;
+            if (g->size == 0) {
+                unused_groups_push_front(g);
+            } else {
+                g->prev_group = last_kept;
+                if (last_kept == nullptr) {
+                    first_kept = g;
+                } else {
+                    last_kept->next_group = g;
+                }
+                last_kept = g;
+                if (!g->is_packed()) {
+                    g->next_erasure_ = std::exchange(erasures, g);
+                }
+            }
+            g = next;
+        }
+        groups_with_erasures_ = erasures;
+        if (last_kept == nullptr) {
+            begin_ = iterator();
+            end_ = iterator();
+        } else {
+            last_kept->next_group = nullptr;
+            begin_ = iterator(first_kept, first_kept->skipfield(0));
+            end_ = iterator(last_kept, last_kept->index_of_last_endpoint());
+        }
+        assert_invariants();
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+        return count;
+    }
+
+    template<class H, class Pred>
+    friend typename H::size_type hive_bulk_erase_if(H& h, Pred& pred);
+
     inline void reset_only_group_left(GroupPtr g) {
         groups_with_erasures_ = nullptr;
         g->reset(0, nullptr, nullptr, 0);
@@ -2064,6 +2440,17 @@ public:
 
     inline allocator_type get_allocator() const noexcept { return allocator_; }
 
+    // Groups allocated or deallocated from now on go through pool, or through the
+    // allocator if pool is null. Moving from a hive copies its pool; swap exchanges them.
+    void set_group_pool(hive_group_pool<T, allocator_type, priority> *pool) {
+        if (pool != nullptr && !std::allocator_traits<allocator_type>::is_always_equal::value && pool->get_allocator() != get_allocator()) {
+            SG14_HIVE_THROW(std::invalid_argument("Cannot use a group pool whose allocator is different from the hive's"));
+        }
+        group_pool_ = pool;
+    }
+
+    inline hive_group_pool<T, allocator_type, priority> *group_pool() const noexcept { return group_pool_; }
+
     inline iterator begin() noexcept { return begin_; }
     inline const_iterator begin() const noexcept { return begin_; }
     inline iterator end() noexcept { return end_; }
@@ -2078,6 +2465,15 @@ public:
     inline const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end_); }
     inline const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin_); }
 
+    // The groups that hold the elements, in iteration order.
+    inline hive_segment_range<false> segments() noexcept { return hive_segment_range<false>(begin_.group_); }
+    inline hive_segment_range<true> segments() const noexcept { return hive_segment_range<true>(begin_.group_); }
+
+    // O(log groups), by binary search in an index of the groups sorted by address.
+    // Neither overload modifies the hive, so concurrent calls are safe.
+    inline iterator get_iterator(const_pointer p) noexcept { return iterator_at_address(p); }
+    inline const_iterator get_iterator(const_pointer p) const noexcept { return iterator_at_address(p); }
+
     [[nodiscard]] inline bool empty() const noexcept { return size_ == 0; }
     inline size_type size() const noexcept { return size_; }
     inline size_type max_size() const noexcept { return std::allocator_traits<allocator_type>::max_size(get_allocator()); }
@@ -2156,6 +2552,9 @@ private:
     }
 
     void transfer_group_impl(hive& h, GroupPtr g) {
+        group_index_reserve(1);
+        h.group_index_erase(g);
+        group_index_insert(g);
         if (g->prev_group != nullptr && g->next_group != nullptr) {
             g->prev_group->next_group = g->next_group;
             g->next_group->prev_group = g->prev_group;
@@ -2259,6 +2658,7 @@ public:
                 // Deallocate existing blocks as source allocator is not necessarily able to do so
                 destroy_all_data();
                 blank();
+                group_pool_ = nullptr;
             }
             allocator_ = source.get_allocator();
         }
@@ -2272,6 +2672,7 @@ public:
     {
         assert(&source != this);
         destroy_all_data();
+        blank();
 
         bool should_use_source_allocator = (
             std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value ||
@@ -2283,7 +2684,8 @@ public:
                 std::is_trivially_copyable<allocator_type>::value &&
                 std::is_trivial<GroupPtr>::value &&
                 std::is_trivial<AlignedEltPtr>::value &&
-                std::is_trivial<SkipfieldPtr>::value
+                std::is_trivial<SkipfieldPtr>::value &&
+                std::is_trivial<PtrOf<GroupPtr>>::value
             );
             if constexpr (can_just_memcpy) {
                 std::memcpy(static_cast<void *>(this), &source, sizeof(hive));
@@ -2295,6 +2697,10 @@ public:
                 unused_groups_tail_ = std::move(source.unused_groups_tail_);
                 size_ = source.size_;
                 capacity_ = source.capacity_;
+                group_index_ = std::move(source.group_index_);
+                group_index_size_ = source.group_index_size_;
+                group_index_capacity_ = source.group_index_capacity_;
+                group_pool_ = source.group_pool_;
 #if !SG14_HIVE_P2596
                 min_group_capacity_ = source.min_group_capacity_;
                 max_group_capacity_ = source.max_group_capacity_;
@@ -2359,6 +2765,62 @@ public:
         }
     }
 
+    // Moves every element out of the sparsest groups into the erased cells of the
+    // densest ones, for as long as the remaining groups have room for a whole group,
+    // and deallocates each group so emptied. relocated(from, to) is called after
+    // each move, once the moved-from element at `from` has been destroyed.
+    // Returns the number of elements moved.
+    template<class F>
+    size_type compact(F relocated) {
+        size_type ngroups = 0;
+        for (GroupPtr g = begin_.group_; g != nullptr; g = g->next_group) {
+            ++ngroups;
+        }
+        if (ngroups <= 1) {
+            return 0;
+        }
+        std::unique_ptr<GroupPtr[]> groups = std::make_unique<GroupPtr[]>(ngroups);
+        size_type holes = 0;
+        size_type n = 0;
+        for (GroupPtr g = begin_.group_; g != nullptr; g = g->next_group) {
+            groups[n++] = g;
+            holes += g->index_of_last_endpoint() - g->size;
+        }
+        // Densest first, comparing size/capacity without division.
+        std::stable_sort(groups.get(), groups.get() + ngroups, [](const GroupPtr& a, const GroupPtr& b) {
+            return size_type(a->size) * b->capacity > size_type(b->size) * a->capacity;
+        });
+
+        size_type moved = 0;
+        size_type first = 0;
+        for (size_type last = ngroups - 1; first < last; --last) {
+            GroupPtr src = groups[last];
+            holes -= src->index_of_last_endpoint() - src->size;
+            if (holes < src->size) {
+                break;
+            }
+            while (src->size != 0) {
+                while (groups[first]->is_packed()) {
+                    ++first;
+                }
+                assert(first < last);
+                iterator from = iterator(src, src->skipfield(0));
+                pointer old_location = from.operator->();
+                iterator to = emplace_into_hole(groups[first], std::move(*from));
+                erase(from);
+                holes -= 1;
+                moved += 1;
+                relocated(old_location, to.operator->());
+            }
+            GroupPtr g = unused_groups_pop_front();
+            assert(g == src);
+            capacity_ -= g->capacity;
+            deallocate_group(g);
+        }
+        assert_invariants();
+        return moved;
+    }
+
     void trim_capacity() noexcept {
         for (GroupPtr g = unused_groups_; g != nullptr; ) {
             GroupPtr next = g->next_group;
@@ -2430,63 +2892,447 @@ public:
 
     inline void sort() { sort(std::less<T>()); }
 
-    template<class Comp>
-    size_type unique(Comp eq) {
-        size_type count = 0;
-        auto end = cend();
-        for (auto it = cbegin(); it != end; ) {
-            auto previous = it++;
-            if (it == end) {
-                break;
+private:
+    // The first position in the sorted run [first, first+len) at which value could be
+    // inserted: before any equal elements if !Upper, or after them if Upper.
+    template<bool Upper, class Comp>
+    static iterator bound_in_run(iterator first, size_type len, const T& value, Comp& less) {
+        while (len != 0) {
+            size_type half = len / 2;
+            iterator mid = first;
+            mid.advance(half);
+            if (Upper ? !less(value, *mid) : less(*mid, value)) {
+                first = ++mid;
+                len -= half + 1;
+            } else {
+                len = half;
             }
-            if (eq(*it, *previous)) {
-                auto orig = ++count;
-                auto last = it;
-                while (++last != end && eq(*last, *previous)) {
-                    ++count;
+        }
+        return first;
+    }
+
+    // Merges the adjacent sorted runs [first, middle) and [middle, last), of lengths
+    // len1 and len2, moving the shorter run through buf when it fits; otherwise
+    // splits both runs and rotates the inner halves into place, as std::inplace_merge
+    // does when it can't get a large enough buffer.
+    template<class Comp>
+    void merge_runs(iterator first, iterator middle, iterator last, size_type len1, size_type len2, T *buf, size_type bufsize, Comp& less) {
+        if (len1 == 0 || len2 == 0) {
+            return;
+        }
+        allocator_type ea = get_allocator();
+        if (len1 <= len2 && len1 <= bufsize) {
+            T *b = buf;
+            for (iterator it = first; it != middle; ++it) {
+                std::allocator_traits<allocator_type>::construct(ea, b++, std::move(*it));
+            }
+            hive_try_finally([&]() {
+                T *bfirst = buf;
+                iterator out = first;
+                while (bfirst != b && middle != last) {
+                    if (less(*middle, *bfirst)) {
+                        *out = std::move(*middle);
+                        ++middle;
+                    } else {
+                        *out = std::move(*bfirst);
+                        ++bfirst;
+                    }
+                    ++out;
                 }
-                if (count != orig) {
-                    it = erase(it, last);
-                } else {
-                    it = erase(it);
+                std::move(bfirst, b, out);
+            }, [&]() {
+                for (T *p = buf; p != b; ++p) {
+                    std::allocator_traits<allocator_type>::destroy(ea, p);
+                }
+            });
+        } else if (len2 <= bufsize) {
+            T *b = buf;
+            for (iterator it = middle; it != last; ++it) {
+                std::allocator_traits<allocator_type>::construct(ea, b++, std::move(*it));
+            }
+            hive_try_finally([&]() {
+                T *blast = b;
+                iterator out = last;
+                while (blast != buf && middle != first) {
+                    iterator prev = std::prev(middle);
+                    --out;
+                    if (less(blast[-1], *prev)) {
+                        *out = std::move(*prev);
+                        middle = prev;
+                    } else {
+                        *out = std::move(*--blast);
+                    }
+                }
+                std::move_backward(buf, blast, out);
+            }, [&]() {
+                for (T *p = buf; p != b; ++p) {
+                    std::allocator_traits<allocator_type>::destroy(ea, p);
                 }
-                end = cend();
+            });
+        } else {
+            iterator cut1 = first;
+            iterator cut2 = middle;
+            size_type len11;
+            size_type len22;
+            if (len1 > len2) {
+                len11 = len1 / 2;
+                cut1.advance(len11);
+                cut2 = bound_in_run<false>(middle, len2, *cut1, less);
+                len22 = middle.distance(cut2);
+            } else {
+                len22 = len2 / 2;
+                cut2.advance(len22);
+                cut1 = bound_in_run<true>(first, len1, *cut2, less);
+                len11 = first.distance(cut1);
             }
+            iterator new_middle = std::rotate(cut1, middle, cut2);
+            merge_runs(first, cut1, new_middle, len11, len22, buf, bufsize, less);
+            merge_runs(new_middle, cut2, last, len1 - len11, len2 - len22, buf, bufsize, less);
+        }
+    }
+
+    // Calls sort_group(g, buf) on each group, with scratch space for scratch_per_cell
+    // elements per cell of the largest group; then merges the groups' sorted runs
+    // pairwise through the same scratch space.
+    template<class SortGroup, class Comp>
+    void sort_by_groups(size_type scratch_per_cell, SortGroup sort_group, Comp less) {
+        if (size_ <= 1) {
+            return;
+        }
+        size_type ngroups = 0;
+        size_type maxcap = 0;
+        for (GroupPtr g = begin_.group_; g != nullptr; g = g->next_group) {
+            ngroups += 1;
+            maxcap = (g->capacity > maxcap) ? g->capacity : maxcap;
         }
+        allocator_type ea = get_allocator();
+        size_type bufsize = maxcap * scratch_per_cell;
+        pointer buf = std::allocator_traits<allocator_type>::allocate(ea, bufsize);
+        hive_try_finally([&]() {
+            T *b = cast_pointer<T*>(buf);
+            struct Run {
+                iterator first_;
+                size_type len_;
+            };
+            std::unique_ptr<Run[]> runs = std::make_unique<Run[]>(ngroups);
+            size_type n = 0;
+            for (GroupPtr g = begin_.group_; g != nullptr; g = g->next_group) {
+                sort_group(g, b);
+                runs[n++] = Run{iterator(g, g->skipfield(0)), g->size};
+            }
+            while (n > 1) {
+                size_type m = 0;
+                for (size_type i = 0; i < n; i += 2) {
+                    if (i + 1 == n) {
+                        runs[m++] = runs[i];
+                    } else {
+                        iterator last = (i + 2 < n) ? runs[i + 2].first_ : end_;
+                        merge_runs(runs[i].first_, runs[i + 1].first_, last, runs[i].len_, runs[i + 1].len_, b, bufsize, less);
+                        runs[m++] = Run{runs[i].first_, runs[i].len_ + runs[i + 1].len_};
+                    }
+                }
+                n = m;
+            }
+        }, [&]() {
+            std::allocator_traits<allocator_type>::deallocate(ea, buf, bufsize);
+        });
         assert_invariants();
-        return count;
+    }
+
+public:
+    // Sorts like sort(less), but with scratch space for only one group's worth of
+    // elements instead of a (pointer, index) pair per element: each group is sorted
+    // through that space, and then the groups are merged in place.
+    template<class Comp>
+    void sort_in_place(Comp less) {
+        allocator_type ea = get_allocator();
+        sort_by_groups(1, [&](GroupPtr g, T *buf) {
+            T *b = buf;
+            size_type endpoint = g->index_of_last_endpoint();
+            for (size_type i = g->skipfield(0); i != endpoint; i += 1 + g->skipfield(i + 1)) {
+                std::allocator_traits<allocator_type>::construct(ea, b++, std::move(*g->element(i).t()));
+            }
+            hive_try_finally([&]() {
+                std::sort(buf, b, less);
+                T *p = buf;
+                for (size_type i = g->skipfield(0); i != endpoint; i += 1 + g->skipfield(i + 1)) {
+                    *g->element(i).t() = std::move(*p++);
+                }
+            }, [&]() {
+                for (T *p = buf; p != b; ++p) {
+                    std::allocator_traits<allocator_type>::destroy(ea, p);
+                }
+            });
+        }, less);
+    }
+
+    inline void sort_in_place() { sort_in_place(std::less<T>()); }
+
+    // Sorts trivially copyable elements by the unsigned integer key proj(t), with an
+    // LSD radix sort of each group (one pass per byte in which the group's keys differ)
+    // followed by the same in-place merge of groups as sort_in_place.
+    template<class Proj>
+    void radix_sort(Proj proj) {
+        using Key = std::decay_t<decltype(proj(std::declval<const T&>()))>;
+        static_assert(std::is_trivially_copyable<T>::value, "radix_sort requires a trivially copyable value_type");
+        static_assert(std::is_unsigned<Key>::value, "radix_sort requires a projection to an unsigned integer type");
+        auto less = [&](const T& a, const T& b) { return proj(a) < proj(b); };
+        sort_by_groups(2, [&](GroupPtr g, T *buf) {
+            T *src = buf;
+            T *dst = buf + g->capacity;
+            size_type n = 0;
+            size_type endpoint = g->index_of_last_endpoint();
+            for (size_type i = g->skipfield(0); i != endpoint; i += 1 + g->skipfield(i + 1)) {
+                std::memcpy(static_cast<void*>(src + n++), cast_pointer<const void*>(g->element(i).t()), sizeof(T));
+            }
+            for (size_t shift = 0; shift < 8 * sizeof(Key); shift += 8) {
+                size_type count[257] = {};
+                for (size_type i = 0; i != n; ++i) {
+                    count[((proj(src[i]) >> shift) & 0xFF) + 1] += 1;
+                }
+                if (std::find(count + 1, count + 257, n) != count + 257) {
+                    continue;  // every key has the same byte here
+                }
+                for (size_type b = 1; b != 257; ++b) {
+                    count[b] += count[b - 1];
+                }
+                for (size_type i = 0; i != n; ++i) {
+                    size_type k = count[(proj(src[i]) >> shift) & 0xFF]++;
+                    std::memcpy(static_cast<void*>(dst + k), static_cast<const void*>(src + i), sizeof(T));
+                }
+                std::swap(src, dst);
+            }
+            T *p = src;
+            for (size_type i = g->skipfield(0); i != endpoint; i += 1 + g->skipfield(i + 1)) {
+                std::memcpy(cast_pointer<void*>(g->element(i).t()), static_cast<const void*>(p++), sizeof(T));
+            }
+        }, less);
+    }
+
+    template<class Comp>
+    size_type unique(Comp eq) {
+        T *previous = nullptr;
+        auto pred = [&](T& t) {
+            if (previous != nullptr && eq(t, *previous)) {
+                return true;
+            }
+            previous = std::addressof(t);
+            return false;
+        };
+        return bulk_erase_if(pred);
     }
 
     inline size_type unique() { return unique(std::equal_to<T>()); }
 };
 
+// A thread-safe free list of group blocks, shared by any number of hives of the
+// same type, so that a group released by one hive can be reused by another without
+// a round trip to the allocator. Groups are bucketed by capacity and reused only
+// at exactly the capacity requested. The pool must outlive every hive using it,
+// and their allocators must compare equal to the pool's.
+template<class T, class allocator_type, class priority>
+class hive_group_pool {
+    using Hive = sg14::hive<T, allocator_type, priority>;
+    using GroupPtr = typename Hive::GroupPtr;
+    friend Hive;
+
+    static size_t bucket_of(size_t cap) {
+        size_t b = 0;
+        while (cap >>= 1) {
+            ++b;
+        }
+        return b;
+    }
+
+public:
+    explicit hive_group_pool(const allocator_type& alloc = allocator_type()) : allocator_(alloc) {}
+    hive_group_pool(const hive_group_pool&) = delete;
+    hive_group_pool& operator=(const hive_group_pool&) = delete;
+    ~hive_group_pool() { release(); }
+
+    inline allocator_type get_allocator() const noexcept { return allocator_; }
+
+    // The number of groups in the pool, and the total number of elements they can hold.
+    size_t size() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return size_;
+    }
+    size_t capacity() const {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return capacity_;
+    }
+
+    // Returns every group in the pool to the allocator.
+    void release() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        for (GroupPtr& head : buckets_) {
+            while (head != nullptr) {
+                GroupPtr g = std::exchange(head, head->next_group);
+                Hive::GroupAllocHelper::deallocate_group(allocator_, g);
+            }
+        }
+        size_ = 0;
+        capacity_ = 0;
+    }
+
+private:
+    GroupPtr take(size_t cap) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        GroupPtr *link = &buckets_[bucket_of(cap)];
+        while (*link != nullptr && (*link)->capacity != cap) {
+            link = &(*link)->next_group;
+        }
+        GroupPtr g = *link;
+        if (g != nullptr) {
+            *link = g->next_group;
+            size_ -= 1;
+            capacity_ -= cap;
+        }
+        return g;
+    }
+
+    void give(GroupPtr g) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        GroupPtr& head = buckets_[bucket_of(g->capacity)];
+        g->next_group = std::exchange(head, g);
+        size_ += 1;
+        capacity_ += g->capacity;
+    }
+
+    mutable std::mutex mtx_;
+    GroupPtr buckets_[std::numeric_limits<typename priority::skipfield_type>::digits + 1] = {};
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    allocator_type allocator_;
+};
+
+// Calls f on each element of h, in iteration order, one group at a time.
+// Returns f, like std::for_each.
+template<class T, class A, class P, class F>
+F hive_for_each(sg14::hive<T, A, P>& h, F f) {
+    for (const auto& seg : h.segments()) {
+        seg.for_each(f);
+    }
+    return f;
+}
+
+template<class T, class A, class P, class F>
+F hive_for_each(const sg14::hive<T, A, P>& h, F f) {
+    for (const auto& seg : h.segments()) {
+        seg.for_each(f);
+    }
+    return f;
+}
+
+// The group-at-a-time erase path shared by std::erase_if, hive::unique, and
+// hive_parallel_erase_if.
+template<class H, class Pred>
+typename H::size_type hive_bulk_erase_if(H& h, Pred& pred) {
+    return h.bulk_erase_if(pred);
+}
+
+// Calls work(first, last) for consecutive ranges of segs, each on its own thread
+// and each with about the same number of cells. If any call throws, the first
+// exception is rethrown once all the threads have finished.
+template<class Segment, class Work>
+void hive_parallel_segments(const std::vector<Segment>& segs, size_t thread_count, Work work) {
+    if (thread_count == 0) {
+        thread_count = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+    thread_count = (std::min)(thread_count, segs.size());
+    if (thread_count <= 1) {
+        work(size_t(0), segs.size());
+        return;
+    }
+    size_t total = 0;
+    for (const auto& seg : segs) {
+        total += seg.extent();
+    }
+    std::vector<size_t> bounds = {0};
+    size_t cells = 0;
+    for (size_t i = 0; i + 1 < segs.size() && bounds.size() < thread_count; ++i) {
+        cells += segs[i].extent();
+        if (cells * thread_count >= total * bounds.size()) {
+            bounds.push_back(i + 1);
+        }
+    }
+    bounds.push_back(segs.size());
+
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto run = [&](size_t k) {
+        try {
+            work(bounds[k], bounds[k + 1]);
+        } catch (...) {
+            std::lock_guard<std::mutex> lk(error_mutex);
+            if (error == nullptr) {
+                error = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(bounds.size() - 2);
+    sg14::hive_try_finally([&]() {
+        for (size_t k = 1; k + 1 < bounds.size(); ++k) {
+            threads.emplace_back(run, k);
+        }
+        run(0);
+    }, [&]() {
+        for (auto& t : threads) {
+            t.join();
+        }
+    });
+    if (error != nullptr) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Calls f on each element of h, splitting the groups among thread_count threads
+// (or std::thread::hardware_concurrency() threads, if thread_count is zero).
+// f is called concurrently, so it must not modify anything it shares between calls.
+template<class T, class A, class P, class F>
+void hive_parallel_for_each(sg14::hive<T, A, P>& h, F f, size_t thread_count = 0) {
+    auto range = h.segments();
+    auto segs = std::vector<typename sg14::hive<T, A, P>::segment>(range.begin(), range.end());
+    sg14::hive_parallel_segments(segs, thread_count, [&](size_t first, size_t last) {
+        for (size_t i = first; i != last; ++i) {
+            segs[i].for_each(f);
+        }
+    });
+}
+
+// Erases every element of h for which pred is true, and returns the number erased.
+// pred is evaluated concurrently on thread_count threads, as for hive_parallel_for_each;
+// then the matching elements are erased in one serial pass over the groups.
+// If pred throws, h is unchanged.
+template<class T, class A, class P, class Pred>
+typename sg14::hive<T, A, P>::size_type hive_parallel_erase_if(sg14::hive<T, A, P>& h, Pred pred, size_t thread_count = 0) {
+    auto range = h.segments();
+    auto segs = std::vector<typename sg14::hive<T, A, P>::segment>(range.begin(), range.end());
+    auto offsets = std::vector<size_t>(segs.size() + 1);
+    for (size_t i = 0; i != segs.size(); ++i) {
+        offsets[i + 1] = offsets[i] + segs[i].size();
+    }
+    // One entry per element, in iteration order: true if it is to be erased.
+    auto doomed = std::vector<unsigned char>(offsets.back());
+    sg14::hive_parallel_segments(segs, thread_count, [&](size_t first, size_t last) {
+        for (size_t i = first; i != last; ++i) {
+            unsigned char *d = doomed.data() + offsets[i];
+            segs[i].for_each([&](T& t) { *d++ = pred(t) ? 1 : 0; });
+        }
+    });
+    const unsigned char *d = doomed.data();
+    auto next_doomed = [&](T&) { return *d++ != 0; };
+    return sg14::hive_bulk_erase_if(h, next_doomed);
+}
+
 } // namespace sg14
 
 namespace std {
 
     template<class T, class A, class P, class Pred>
     typename sg14::hive<T, A, P>::size_type erase_if(sg14::hive<T, A, P>& h, Pred pred) {
-        typename sg14::hive<T, A, P>::size_type count = 0;
-        auto end = h.end();
-        for (auto it = h.begin(); it != end; ++it) {
-            if (pred(*it)) {
-                auto orig = ++count;
-                auto last = it;
-                while (++last != end && pred(*last)) {
-                    ++count;
-                }
-                if (count != orig) {
-                    it = h.erase(it, last);
-                } else {
-                    it = h.erase(it);
-                }
-                end = h.end();
-                if (it == end) {
-                    break;
-                }
-            }
-        }
-        return count;
+        return sg14::hive_bulk_erase_if(h, pred);
     }
 
     template<class T, class A, class P>
@@ -26,11 +26,27 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+#if !(defined(__GNUC__) || defined(__clang__)) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
 #ifndef SLOT_MAP_THROW_EXCEPTION
 #include <stdexcept>
 #define SLOT_MAP_THROW_EXCEPTION(type, ...) throw type(__VA_ARGS__)
@@ -58,26 +74,205 @@ inline void reserve_if_possible(Ctr& ctr, const SizeType& n)
     slot_map_detail::reserve_if_possible(ctr, n, priority_tag<1>{});
 }
 
-} // namespace slot_map_detail
+template<class Ctr>
+inline auto shrink_to_fit_if_possible(Ctr&, priority_tag<0>) -> void {}
 
-template<
-    class T,
-    class Key = std::pair<unsigned, unsigned>,
-    template<class...> class Container = std::vector
->
-class slot_map
+template<class Ctr>
+inline auto shrink_to_fit_if_possible(Ctr& ctr, priority_tag<1>) -> decltype(void(ctr.shrink_to_fit()))
+{
+    ctr.shrink_to_fit();
+}
+
+template<class Ctr>
+inline void shrink_to_fit_if_possible(Ctr& ctr)
+{
+    slot_map_detail::shrink_to_fit_if_possible(ctr, priority_tag<1>{});
+}
+
+template<class Ctr, class SizeType>
+inline auto grow_if_possible(Ctr&, SizeType, priority_tag<0>) -> void {}
+
+template<class Ctr, class SizeType>
+inline auto grow_if_possible(Ctr& ctr, SizeType n, priority_tag<1>) -> decltype(void(ctr.reserve(ctr.capacity())))
+{
+    // Growing at least geometrically keeps a series of small batches amortized O(1).
+    using size_type = decltype(ctr.capacity());
+    if (ctr.capacity() - ctr.size() < static_cast<size_type>(n)) {
+        ctr.reserve((std::max)(static_cast<size_type>(ctr.size() + n), static_cast<size_type>(2 * ctr.capacity())));
+    }
+}
+
+inline void prefetch(const void *p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#elif defined(_M_X64) || defined(_M_IX86)
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+// Prefetching ctr[i] is worthwhile only if it doesn't take a walk down a list,
+// and possible only if the element has an address.
+template<class Ctr, class Index>
+inline void prefetch_at(const Ctr& ctr, Index i, std::true_type)
+{
+    slot_map_detail::prefetch(std::addressof(*std::next(ctr.begin(), i)));
+}
+
+template<class Ctr, class Index>
+inline void prefetch_at(const Ctr&, Index, std::false_type) {}
+
+template<class Ctr, class Index>
+inline void prefetch_at(const Ctr& ctr, Index i)
 {
+    using It = typename Ctr::const_iterator;
+    using CanPrefetch = std::integral_constant<bool,
+        std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<It>::iterator_category>::value &&
+        std::is_lvalue_reference<decltype(*std::declval<It>())>::value
+    >;
+    slot_map_detail::prefetch_at(ctr, i, CanPrefetch{});
+}
+
+// Makes room for n more elements, if the container supports reserve().
+template<class Ctr, class SizeType>
+inline void grow_if_possible(Ctr& ctr, const SizeType& n)
+{
+    slot_map_detail::grow_if_possible(ctr, n, priority_tag<1>{});
+}
+
+// The largest index that a key can hold: Traits::max_index() if the traits
+// provide it, otherwise the largest value of the key's index type.
+template<class Traits, class Index>
+constexpr auto max_key_index(priority_tag<1>) -> decltype(static_cast<Index>(Traits::max_index()))
+{
+    return static_cast<Index>(Traits::max_index());
+}
+
+template<class Traits, class Index>
+constexpr Index max_key_index(priority_tag<0>)
+{
+    return (std::numeric_limits<Index>::max)();
+}
+
+template<int Bits>
+using uint_least_bits = std::conditional_t<(Bits <= 8), uint8_t,
+                        std::conditional_t<(Bits <= 16), uint16_t,
+                        std::conditional_t<(Bits <= 32), uint32_t, uint64_t>>>;
+
+} // namespace slot_map_detail
+
+// slot_map reads and writes the parts of its keys through slot_map_key_traits.
+// By default, a key is a tuple-like (index, generation) pair whose
+// elements can be accessed by reference. Specialize this template
+// for key types that are represented some other way.
+template<class Key>
+struct slot_map_key_traits {
 #if __cplusplus >= 201703L
     static constexpr auto get_index(const Key& k) { const auto& [idx, gen] = k; return idx; }
     static constexpr auto get_generation(const Key& k) { const auto& [idx, gen] = k; return gen; }
-    template<class Integral> static constexpr void set_index(Key& k, Integral value) { auto& [idx, gen] = k; idx = static_cast<key_index_type>(value); }
+    template<class Index> static constexpr void set_index(Key& k, Index value) { auto& [idx, gen] = k; idx = value; }
     static constexpr void increment_generation(Key& k) { auto& [idx, gen] = k; ++gen; }
 #else
     static constexpr auto get_index(const Key& k) { using std::get; return get<0>(k); }
     static constexpr auto get_generation(const Key& k) { using std::get; return get<1>(k); }
-    template<class Integral> static constexpr void set_index(Key& k, Integral value) { using std::get; get<0>(k) = static_cast<key_index_type>(value); }
+    template<class Index> static constexpr void set_index(Key& k, Index value) { using std::get; get<0>(k) = value; }
     static constexpr void increment_generation(Key& k) { using std::get; ++get<1>(k); }
 #endif
+};
+
+// A slot_map key packed into a single unsigned integer: the index in the low
+// IndexBits, then the generation, then TagBits of user data in the high bits.
+// The generation wraps around within its GenerationBits. slot_map ignores the
+// tag when it looks up a key, so a caller may use the tag bits for, e.g., a type code.
+template<int IndexBits, int GenerationBits, int TagBits = 0>
+class packed_key {
+    static_assert(IndexBits > 0 && GenerationBits > 0 && TagBits >= 0, "");
+    static_assert(IndexBits + GenerationBits + TagBits <= 64, "a packed_key must fit in 64 bits");
+
+    static constexpr int generation_shift = IndexBits;
+    static constexpr int tag_shift = IndexBits + GenerationBits;
+    static constexpr uint64_t mask(int bits) { return (bits == 0) ? 0 : (~uint64_t(0) >> (64 - bits)); }
+
+public:
+    using value_type = slot_map_detail::uint_least_bits<IndexBits + GenerationBits + TagBits>;
+    using index_type = slot_map_detail::uint_least_bits<IndexBits>;
+    using generation_type = slot_map_detail::uint_least_bits<GenerationBits>;
+    using tag_type = slot_map_detail::uint_least_bits<(TagBits == 0) ? 1 : TagBits>;
+
+    static constexpr int index_bits = IndexBits;
+    static constexpr int generation_bits = GenerationBits;
+    static constexpr int tag_bits = TagBits;
+
+    constexpr packed_key() = default;
+    constexpr packed_key(index_type index, generation_type generation, tag_type tag = 0) :
+        value_(static_cast<value_type>(
+            (uint64_t(index) & mask(IndexBits)) |
+            ((uint64_t(generation) & mask(GenerationBits)) << generation_shift) |
+            ((uint64_t(tag) & mask(TagBits)) << (tag_shift % 64))
+        )) {}
+
+    static constexpr index_type max_index() { return static_cast<index_type>(mask(IndexBits)); }
+
+    static constexpr packed_key from_value(value_type v) { packed_key k; k.value_ = v; return k; }
+    constexpr value_type value() const { return value_; }
+
+    constexpr index_type index() const { return static_cast<index_type>(value_ & mask(IndexBits)); }
+    constexpr generation_type generation() const { return static_cast<generation_type>((value_ >> generation_shift) & mask(GenerationBits)); }
+    constexpr tag_type tag() const { return static_cast<tag_type>((uint64_t(value_) >> (tag_shift % 64)) & mask(TagBits)); }
+
+    constexpr void set_index(index_type index) { value_ = replace_bits(index, 0, IndexBits); }
+    constexpr void set_generation(generation_type generation) { value_ = replace_bits(generation, generation_shift, GenerationBits); }
+    constexpr void set_tag(tag_type tag) { value_ = replace_bits(tag, tag_shift % 64, TagBits); }
+
+    friend constexpr bool operator==(const packed_key& a, const packed_key& b) { return a.value_ == b.value_; }
+    friend constexpr bool operator!=(const packed_key& a, const packed_key& b) { return a.value_ != b.value_; }
+    friend constexpr bool operator<(const packed_key& a, const packed_key& b) { return a.value_ < b.value_; }
+
+private:
+    constexpr value_type replace_bits(uint64_t bits, int shift, int width) const {
+        return static_cast<value_type>((uint64_t(value_) & ~(mask(width) << shift)) | ((bits & mask(width)) << shift));
+    }
+
+    value_type value_ = 0;
+};
+
+// Like a pair, a packed_key can be destructured into (index, generation).
+template<size_t I, int IB, int GB, int TB>
+constexpr auto get(const packed_key<IB, GB, TB>& k) -> std::conditional_t<I == 0, typename packed_key<IB, GB, TB>::index_type, typename packed_key<IB, GB, TB>::generation_type> {
+    static_assert(I < 2, "");
+    return (I == 0) ? k.index() : k.generation();
+}
+
+template<int IB, int GB, int TB>
+struct slot_map_key_traits<packed_key<IB, GB, TB>> {
+    using key_type = packed_key<IB, GB, TB>;
+    static constexpr auto get_index(const key_type& k) { return k.index(); }
+    static constexpr auto get_generation(const key_type& k) { return k.generation(); }
+    static constexpr auto max_index() { return key_type::max_index(); }
+    template<class Index> static constexpr void set_index(key_type& k, Index value) { k.set_index(static_cast<typename key_type::index_type>(value)); }
+    static constexpr void increment_generation(key_type& k) { k.set_generation(static_cast<typename key_type::generation_type>(k.generation() + 1)); }
+};
+
+// The order in which a slot_map hands out the slots freed by erase.
+// fifo reuses the slot that has been free the longest, which spreads
+// the generation increments evenly and so delays wraparound;
+// lifo reuses the slot freed most recently, which is likely still in cache.
+enum class slot_reuse_policy { fifo, lifo };
+
+template<
+    class T,
+    class Key = std::pair<unsigned, unsigned>,
+    template<class...> class Container = std::vector
+>
+class slot_map
+{
+    using key_traits = slot_map_key_traits<Key>;
+    static constexpr auto get_index(const Key& k) { return key_traits::get_index(k); }
+    static constexpr auto get_generation(const Key& k) { return key_traits::get_generation(k); }
+    template<class Integral> static constexpr void set_index(Key& k, Integral value) { key_traits::set_index(k, static_cast<key_index_type>(value)); }
+    static constexpr void increment_generation(Key& k) { key_traits::increment_generation(k); }
 
     using slot_iterator = typename Container<Key>::iterator;
 
@@ -188,6 +383,46 @@ public:
         return value_iter;
     }
 
+    // The find_many() functions write to result the iterator that find()
+    // would have returned for each key in [first, last), and the
+    // find_unchecked_many() functions likewise for find_unchecked().
+    // The keys are resolved in groups, so that the cache misses on the slots,
+    // and then on the values, of a whole group are in flight at once.
+    // O(n) time complexity.
+    //
+    template<class ForwardIterator, class OutputIterator>
+    constexpr OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator result) {
+        this->resolve_many(first, last, std::true_type{}, [&](size_type value_index) {
+            *result = std::next(this->begin(), value_index);
+            ++result;
+        });
+        return result;
+    }
+    template<class ForwardIterator, class OutputIterator>
+    constexpr OutputIterator find_many(ForwardIterator first, ForwardIterator last, OutputIterator result) const {
+        this->resolve_many(first, last, std::true_type{}, [&](size_type value_index) {
+            *result = std::next(this->begin(), value_index);
+            ++result;
+        });
+        return result;
+    }
+    template<class ForwardIterator, class OutputIterator>
+    constexpr OutputIterator find_unchecked_many(ForwardIterator first, ForwardIterator last, OutputIterator result) {
+        this->resolve_many(first, last, std::false_type{}, [&](size_type value_index) {
+            *result = std::next(this->begin(), value_index);
+            ++result;
+        });
+        return result;
+    }
+    template<class ForwardIterator, class OutputIterator>
+    constexpr OutputIterator find_unchecked_many(ForwardIterator first, ForwardIterator last, OutputIterator result) const {
+        this->resolve_many(first, last, std::false_type{}, [&](size_type value_index) {
+            *result = std::next(this->begin(), value_index);
+            ++result;
+        });
+        return result;
+    }
+
     // All begin() and end() variations have O(1) time and space complexity.
     //
     constexpr iterator begin()                         { return values_.begin(); }
@@ -227,16 +462,20 @@ public:
     // Functions for accessing and modifying the size of the slots container.
     // These are beneficial as allocating more slots than values will cause the
     // generation counter increases to be more evenly distributed across the slots.
+    // reserve_slots(n) throws length_error if a key cannot hold the index n.
     //
     constexpr void reserve_slots(size_type n) {
+        if (n > max_slot_count()) {
+            SLOT_MAP_THROW_EXCEPTION(std::length_error, "reserve_slots");
+        }
         slot_map_detail::reserve_if_possible(slots_, n);
         key_index_type original_num_slots = static_cast<key_index_type>(slots_.size());
         if (original_num_slots < n) {
-            slots_.emplace_back(key_type{next_available_slot_index_, key_generation_type{}});
+            slots_.emplace_back(key_type{next_available_slot_index_, first_generation_});
             key_index_type last_new_slot = original_num_slots;
             --n;
             while (last_new_slot != n) {
-                slots_.emplace_back(key_type{last_new_slot, key_generation_type{}});
+                slots_.emplace_back(key_type{last_new_slot, first_generation_});
                 ++last_new_slot;
             }
             next_available_slot_index_ = last_new_slot;
@@ -244,20 +483,82 @@ public:
     }
     constexpr size_type slot_count() const { return slots_.size(); }
 
+    // shrink_slots() removes the free slots at the end of the slots container,
+    // whether they were never handed out or are merely no longer in use,
+    // and returns the number of slots removed. Slots created afterward start
+    // at the highest generation of any removed slot, so the keys that referred
+    // to a removed slot remain invalid.
+    // O(slot_count()) time complexity.
+    //
+    constexpr size_type shrink_slots() {
+        key_index_type new_count{};
+        for (key_index_type slot_index : reverse_map_) {
+            new_count = (std::max)(new_count, static_cast<key_index_type>(slot_index + 1));
+        }
+        size_type old_count = slots_.size();
+        if (new_count == old_count) {
+            return 0;
+        }
+        // Relink the free list without the removed slots, keeping its order.
+        key_index_type head = new_count;
+        key_index_type tail = new_count;
+        if (next_available_slot_index_ != old_count) {
+            key_index_type slot_index = next_available_slot_index_;
+            while (true) {
+                auto slot_iter = std::next(slots_.begin(), slot_index);
+                key_index_type next_index = get_index(*slot_iter);
+                if (slot_index < new_count) {
+                    if (head == new_count) {
+                        head = slot_index;
+                    } else {
+                        this->set_index(*std::next(slots_.begin(), tail), slot_index);
+                    }
+                    tail = slot_index;
+                } else {
+                    first_generation_ = (std::max)(first_generation_, get_generation(*slot_iter));
+                }
+                if (slot_index == last_available_slot_index_) {
+                    break;
+                }
+                slot_index = next_index;
+            }
+        }
+        for (size_type i = new_count; i != old_count; ++i) {
+            slots_.pop_back();
+        }
+        slot_map_detail::shrink_to_fit_if_possible(slots_);
+        next_available_slot_index_ = head;
+        last_available_slot_index_ = tail;
+        return old_count - new_count;
+    }
+
+    // The reuse policy determines which free slot the next insertion takes;
+    // see slot_reuse_policy. It may be changed at any time.
+    // O(1) time and space complexity.
+    //
+    constexpr slot_reuse_policy reuse_policy() const { return reuse_policy_; }
+    constexpr void set_reuse_policy(slot_reuse_policy policy) { reuse_policy_ = policy; }
+
     // These operations have O(1) time and space complexity.
     // When size() == capacity() an allocation is required
     // which has O(n) time and space complexity.
+    // They throw length_error if the new slot's index could not be held in a key.
     //
     constexpr key_type insert(const mapped_type& value)   { return this->emplace(value); }
     constexpr key_type insert(mapped_type&& value)        { return this->emplace(std::move(value)); }
 
     template<class... Args> constexpr key_type emplace(Args&&... args) {
+        // A free slot exists unless size() == slots_.size(), in which case
+        // the new slot's index, and then slots_.size(), must fit in a key.
+        if (values_.size() >= max_slot_count()) {
+            SLOT_MAP_THROW_EXCEPTION(std::length_error, "emplace");
+        }
         auto value_pos = values_.size();
         values_.emplace_back(std::forward<Args>(args)...);
         reverse_map_.emplace_back(next_available_slot_index_);
         if (next_available_slot_index_ == slots_.size()) {
             auto idx = next_available_slot_index_; ++idx;
-            slots_.emplace_back(key_type{idx, key_generation_type{}});  // make a new slot
+            slots_.emplace_back(key_type{idx, first_generation_});  // make a new slot
             last_available_slot_index_ = idx;
         }
         auto slot_iter = std::next(slots_.begin(), next_available_slot_index_);
@@ -273,6 +574,32 @@ public:
         return result;
     }
 
+    // The batch insertion functions make room for all the new values at once,
+    // then write the key of each new value to key_out, in order.
+    // If an exception is thrown, the values inserted so far remain in the slot_map;
+    // but if the keys could not index them all, length_error is thrown up front.
+    // O(n) time complexity, amortized.
+    //
+    template<class OutputIt, class... Args>
+    constexpr OutputIt emplace_n(size_type n, OutputIt key_out, const Args&... args) {
+        this->grow_for_insert(n);
+        for (size_type i = 0; i != n; ++i) {
+            *key_out = this->emplace(args...);
+            ++key_out;
+        }
+        return key_out;
+    }
+
+    template<class It, class OutputIt, class = std::enable_if_t<!std::is_integral<It>::value>>
+    constexpr OutputIt insert(It first, It last, OutputIt key_out) {
+        this->grow_for_insert(first, last, typename std::iterator_traits<It>::iterator_category{});
+        for ( ; first != last; ++first) {
+            *key_out = this->emplace(*first);
+            ++key_out;
+        }
+        return key_out;
+    }
+
     // Each erase() version has an O(1) time complexity per value
     // and O(1) space complexity.
     //
@@ -286,11 +613,17 @@ public:
         // Must use indexes, not iterators, because Container iterators might be invalidated by pop_back
         auto first_index = std::distance(this->cbegin(), first);
         auto last_index = std::distance(this->cbegin(), last);
-        while (last_index != first_index) {
-            --last_index;
-            auto iter = std::next(this->cbegin(), last_index);
-            this->erase(iter);
+        // Expire the slots from back to front, as a series of single erases would.
+        std::vector<key_type> keys;
+        keys.reserve(last_index - first_index);
+        auto reverse_map_iter = std::next(reverse_map_.begin(), last_index);
+        for (auto i = last_index; i != first_index; --i) {
+            --reverse_map_iter;
+            key_type key = *std::next(slots_.begin(), *reverse_map_iter);
+            this->set_index(key, *reverse_map_iter);
+            keys.push_back(key);
         }
+        this->erase_keys(keys.begin(), keys.end());
         return std::next(this->begin(), first_index);
     }
     constexpr size_type erase(const key_type& key) {
@@ -302,6 +635,64 @@ public:
         return 1;
     }
 
+    // erase_keys() erases the value of each valid key in the range,
+    // skipping stale and duplicate keys, and returns the number of values erased.
+    // The values are compacted in a single pass, and the freed slots are
+    // appended to the free list all at once.
+    // O(n) time complexity in the number of keys.
+    //
+    template<class InputIt>
+    constexpr size_type erase_keys(InputIt first, InputIt last) {
+        std::vector<key_index_type> dead;
+        slot_iterator chain_head = slots_.end();
+        slot_iterator chain_tail = slots_.end();
+        for ( ; first != last; ++first) {
+            const key_type& key = *first;
+            auto slot_index = get_index(key);
+            if (slot_index >= slots_.size()) {
+                continue;
+            }
+            auto slot_iter = std::next(slots_.begin(), slot_index);
+            if (get_generation(*slot_iter) != get_generation(key)) {
+                continue;
+            }
+            dead.push_back(get_index(*slot_iter));
+            // Expire this key now, so that a duplicate of it is skipped.
+            this->increment_generation(*slot_iter);
+            if (chain_tail == slots_.end()) {
+                chain_head = slot_iter;
+            } else {
+                this->set_index(*chain_tail, slot_index);
+            }
+            chain_tail = slot_iter;
+        }
+        if (dead.empty()) {
+            return 0;
+        }
+        this->compact_values(dead);
+        // Splice the chain of freed slots onto the free list.
+        auto head_index = static_cast<key_index_type>(std::distance(slots_.begin(), chain_head));
+        auto tail_index = static_cast<key_index_type>(std::distance(slots_.begin(), chain_tail));
+        if (next_available_slot_index_ == slots_.size()) {
+            next_available_slot_index_ = head_index;
+            last_available_slot_index_ = tail_index;
+        } else if (reuse_policy_ == slot_reuse_policy::lifo) {
+            this->set_index(*chain_tail, next_available_slot_index_);
+            next_available_slot_index_ = head_index;
+        } else {
+            auto last_slot_iter = std::next(slots_.begin(), last_available_slot_index_);
+            this->set_index(*last_slot_iter, head_index);
+            last_available_slot_index_ = tail_index;
+        }
+        return dead.size();
+    }
+
+#if __cpp_lib_span >= 202002L
+    constexpr size_type erase(std::span<const key_type> keys) {
+        return this->erase_keys(keys.begin(), keys.end());
+    }
+#endif
+
     constexpr void underlying_swap(const_iterator cit, const_iterator cjt) {
         // Swap *it and *jt in the underlying container,
         // but then fix up their keys so they don't appear to move.
@@ -342,6 +733,64 @@ public:
         }
     }
 
+    // apply_permutation() reorders the values so that the value at index perm[i]
+    // moves to index i, where [first, last) is a permutation of [0, size()).
+    // sort() sorts the values by comp. Every key remains valid.
+    // Each value is moved once or twice, by following the cycles of the
+    // permutation in place; then both index maps are fixed up in one pass.
+    // O(n) time complexity, plus O(n log n) comparisons for sort.
+    //
+    template<class RandomIt>
+    constexpr void apply_permutation(RandomIt first, RandomIt last) {
+        size_type n = static_cast<size_type>(last - first);
+        std::vector<key_index_type> old_reverse_map(reverse_map_.begin(), reverse_map_.end());
+        std::vector<bool> done(n);
+        for (size_type i = 0; i != n; ++i) {
+            if (done[i]) {
+                continue;
+            }
+            done[i] = true;
+            size_type j = i;
+            size_type k = static_cast<size_type>(first[j]);
+            if (k == i) {
+                continue;
+            }
+            auto j_iter = std::next(values_.begin(), j);
+            mapped_type tmp = std::move(*j_iter);
+            while (k != i) {
+                auto k_iter = std::next(values_.begin(), k);
+                *j_iter = std::move(*k_iter);
+                done[k] = true;
+                j = k;
+                j_iter = k_iter;
+                k = static_cast<size_type>(first[j]);
+            }
+            *j_iter = std::move(tmp);
+        }
+        auto reverse_map_iter = reverse_map_.begin();
+        for (size_type i = 0; i != n; ++i, ++reverse_map_iter) {
+            key_index_type slot_index = old_reverse_map[static_cast<size_type>(first[i])];
+            *reverse_map_iter = slot_index;
+            this->set_index(*std::next(slots_.begin(), slot_index), i);
+        }
+    }
+#if __cpp_lib_span >= 202002L
+    constexpr void apply_permutation(std::span<const size_t> perm) {
+        this->apply_permutation(perm.begin(), perm.end());
+    }
+#endif
+
+    template<class Compare = std::less<>>
+    constexpr void sort(Compare comp = Compare()) {
+        std::vector<size_type> perm(this->size());
+        std::iota(perm.begin(), perm.end(), size_type(0));
+        auto first = this->cbegin();
+        std::sort(perm.begin(), perm.end(), [&](size_type a, size_type b) {
+            return comp(*std::next(first, a), *std::next(first, b));
+        });
+        this->apply_permutation(perm.begin(), perm.end());
+    }
+
     // clear() has O(n) time complexity and O(1) space complexity.
     // It also has semantics differing from erase(begin(), end())
     // in that it also resets the generation counter of every slot
@@ -354,6 +803,7 @@ public:
         reverse_map_.clear();
         next_available_slot_index_ = key_index_type{};
         last_available_slot_index_ = key_index_type{};
+        first_generation_ = key_generation_type{};
     }
 
     // swap is not mentioned in P0661r1 but it should be.
@@ -364,6 +814,8 @@ public:
         swap(reverse_map_, rhs.reverse_map_);
         swap(next_available_slot_index_, rhs.next_available_slot_index_);
         swap(last_available_slot_index_, rhs.last_available_slot_index_);
+        swap(first_generation_, rhs.first_generation_);
+        swap(reuse_policy_, rhs.reuse_policy_);
     }
 
 protected:
@@ -375,6 +827,117 @@ protected:
     constexpr const Container<mapped_type>&& c() const&& noexcept { return std::move(values_); }
 
 private:
+    // Every slot index, and slots_.size() itself (which marks an empty free list),
+    // must fit in a key; so a packed_key with IndexBits bits has 2^IndexBits - 1 slots.
+    static constexpr size_type max_slot_count() {
+        return static_cast<size_type>(slot_map_detail::max_key_index<key_traits, key_index_type>(slot_map_detail::priority_tag<1>{}));
+    }
+
+    constexpr void grow_for_insert(size_type n) {
+        if (n > max_slot_count() - values_.size()) {
+            SLOT_MAP_THROW_EXCEPTION(std::length_error, "insert");
+        }
+        slot_map_detail::grow_if_possible(values_, n);
+        slot_map_detail::grow_if_possible(reverse_map_, n);
+        slot_map_detail::grow_if_possible(slots_, n);
+    }
+    template<class It>
+    constexpr void grow_for_insert(It first, It last, std::forward_iterator_tag) {
+        this->grow_for_insert(static_cast<size_type>(std::distance(first, last)));
+    }
+    template<class It>
+    constexpr void grow_for_insert(It, It, std::input_iterator_tag) {}
+
+    // Calls emit with the value index of each key in [first, last), or with size()
+    // if Checked and the key is stale or out of range.
+    // For a map too big for the cache, the loop is software-pipelined: while
+    // resolving key i, it prefetches the value of key i+D and the slot of key i+2D.
+    template<class ForwardIt, bool Checked, class F>
+    constexpr void resolve_many(ForwardIt first, ForwardIt last, std::integral_constant<bool, Checked>, F&& emit) const {
+        constexpr int D = 8;
+        constexpr size_t MinPrefetchBytes = size_t(1) << 20;
+        auto value_index_of = [&](const key_type& key) {
+            auto slot_index = get_index(key);
+            if (Checked && slot_index >= slots_.size()) {
+                return values_.size();
+            }
+            const key_type& slot = *std::next(slots_.begin(), slot_index);
+            if (Checked && get_generation(slot) != get_generation(key)) {
+                return values_.size();
+            }
+            return static_cast<size_type>(get_index(slot));
+        };
+        if (slots_.size() * sizeof(key_type) < MinPrefetchBytes) {
+            for ( ; first != last; ++first) {
+                emit(value_index_of(*first));
+            }
+            return;
+        }
+        ForwardIt value_ahead = first;
+        ForwardIt slot_ahead = first;
+        for (int i = 0; i < 2 * D && slot_ahead != last; ++i, ++slot_ahead) {
+            if (i == D) {
+                value_ahead = slot_ahead;
+            }
+            auto slot_index = get_index(*slot_ahead);
+            if (!Checked || slot_index < slots_.size()) {
+                slot_map_detail::prefetch_at(slots_, slot_index);
+            }
+        }
+        if (value_ahead == first) {
+            value_ahead = slot_ahead;
+        }
+        for ( ; first != last; ++first) {
+            if (slot_ahead != last) {
+                auto slot_index = get_index(*slot_ahead);
+                if (!Checked || slot_index < slots_.size()) {
+                    slot_map_detail::prefetch_at(slots_, slot_index);
+                }
+                ++slot_ahead;
+            }
+            if (value_ahead != last) {
+                auto value_index = value_index_of(*value_ahead);
+                if (value_index != values_.size()) {
+                    slot_map_detail::prefetch_at(values_, value_index);
+                }
+                ++value_ahead;
+            }
+            emit(value_index_of(*first));
+        }
+    }
+
+    // Removes the values at the given indexes, whose slots have already been expired,
+    // by moving live values from the back into the holes and then popping the back.
+    // No slot index can equal the largest key_index_type, because then
+    // next_available_slot_index_ could not represent slots_.size().
+    constexpr void compact_values(const std::vector<key_index_type>& dead) {
+        constexpr key_index_type dead_mark = (std::numeric_limits<key_index_type>::max)();
+        for (key_index_type value_index : dead) {
+            *std::next(reverse_map_.begin(), value_index) = dead_mark;
+        }
+        size_type n = values_.size();
+        size_type live = n - static_cast<size_type>(dead.size());
+        auto hi_value_iter = values_.end();
+        auto hi_reverse_map_iter = reverse_map_.end();
+        for (key_index_type lo : dead) {
+            if (lo >= live) {
+                continue;
+            }
+            do {
+                --hi_value_iter;
+                --hi_reverse_map_iter;
+            } while (*hi_reverse_map_iter == dead_mark);
+            auto lo_reverse_map_iter = std::next(reverse_map_.begin(), lo);
+            *std::next(values_.begin(), lo) = std::move(*hi_value_iter);
+            *lo_reverse_map_iter = *hi_reverse_map_iter;
+            this->set_index(*std::next(slots_.begin(), *lo_reverse_map_iter), lo);
+        }
+        for (size_type i = live; i != n; ++i) {
+            values_.pop_back();
+            reverse_map_.pop_back();
+        }
+    }
+
     constexpr slot_iterator slot_iter_from_value_iter(const_iterator value_iter) {
         auto value_index = std::distance(const_iterator(values_.begin()), value_iter);
         auto slot_index = *std::next(reverse_map_.begin(), value_index);
@@ -398,6 +961,9 @@ private:
         if (next_available_slot_index_ == slots_.size()) {
             next_available_slot_index_ = static_cast<key_index_type>(slot_index);
             last_available_slot_index_ = static_cast<key_index_type>(slot_index);
+        } else if (reuse_policy_ == slot_reuse_policy::lifo) {
+            this->set_index(*slot_iter, next_available_slot_index_);
+            next_available_slot_index_ = static_cast<key_index_type>(slot_index);
         } else {
             auto last_slot_iter = std::next(slots_.begin(), last_available_slot_index_);
             this->set_index(*last_slot_iter, slot_index);
@@ -412,6 +978,8 @@ private:
     Container<mapped_type> values_;  // exactly size() entries
     key_index_type next_available_slot_index_{};
     key_index_type last_available_slot_index_{};
+    key_generation_type first_generation_{};  // the generation of each newly created slot
+    slot_reuse_policy reuse_policy_ = slot_reuse_policy::fifo;
 
     // Class invariant:
     // Either next_available_slot_index_ == last_available_slot_index_ == slots_.size(),
@@ -427,3 +995,23 @@ constexpr void swap(slot_map<T, Key, Container>& lhs, slot_map<T, Key, Container
 }
 
 } // namespace sg14
+
+namespace std {
+
+template<int IB, int GB, int TB>
+struct tuple_size<sg14::packed_key<IB, GB, TB>> : integral_constant<size_t, 2> {};
+
+template<int IB, int GB, int TB>
+struct tuple_element<0, sg14::packed_key<IB, GB, TB>> { using type = typename sg14::packed_key<IB, GB, TB>::index_type; };
+
+template<int IB, int GB, int TB>
+struct tuple_element<1, sg14::packed_key<IB, GB, TB>> { using type = typename sg14::packed_key<IB, GB, TB>::generation_type; };
+
+template<int IB, int GB, int TB>
+struct hash<sg14::packed_key<IB, GB, TB>> {
+    size_t operator()(const sg14::packed_key<IB, GB, TB>& k) const noexcept {
+        return hash<typename sg14::packed_key<IB, GB, TB>::value_type>()(k.value());
+    }
+};
+
+} // namespace std
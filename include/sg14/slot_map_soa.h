@@ -0,0 +1,361 @@
+/*
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <sg14/slot_map.h>
+
+#include <stddef.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+namespace sg14 {
+
+namespace slot_map_detail {
+
+// A contiguous column of a slot_map_soa, for when std::span is unavailable.
+template<class T>
+class column_span {
+public:
+    using element_type = T;
+    using size_type = size_t;
+    using iterator = T*;
+
+    constexpr explicit column_span(T *data, size_t size) : data_(data), size_(size) {}
+    constexpr T *data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr T *begin() const { return data_; }
+    constexpr T *end() const { return data_ + size_; }
+    constexpr T& operator[](size_t i) const { return data_[i]; }
+
+private:
+    T *data_;
+    size_t size_;
+};
+
+template<class T, class... Ts>
+constexpr size_t count_of_type() { return (size_t(std::is_same_v<T, Ts>) + ... + 0); }
+
+template<class T, class... Ts>
+constexpr size_t index_of_type() {
+    constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+    for (size_t i = 0; i < sizeof...(Ts); ++i) {
+        if (matches[i]) {
+            return i;
+        }
+    }
+    return sizeof...(Ts);
+}
+
+} // namespace slot_map_detail
+
+// slot_map_soa is a slot_map whose values are split into columns: one dense
+// std::vector per component type, all sharing one slot table and one reverse map.
+// The I'th component of the value at dense index i is column<I>()[i]; erasing a value
+// moves the last value's components into its place in every column at once.
+// Loops over one component touch only that component's memory.
+//
+template<class Key, class... Ts>
+class slot_map_soa {
+    static_assert(sizeof...(Ts) >= 1, "slot_map_soa needs at least one column");
+
+    using key_traits = slot_map_key_traits<Key>;
+    static constexpr auto get_index(const Key& k) { return key_traits::get_index(k); }
+    static constexpr auto get_generation(const Key& k) { return key_traits::get_generation(k); }
+    template<class Integral> static constexpr void set_index(Key& k, Integral value) { key_traits::set_index(k, static_cast<key_index_type>(value)); }
+    static constexpr void increment_generation(Key& k) { key_traits::increment_generation(k); }
+
+    template<class T>
+    static constexpr size_t column_index() {
+        static_assert(slot_map_detail::count_of_type<T, Ts...>() == 1, "T must be the type of exactly one column");
+        return slot_map_detail::index_of_type<T, Ts...>();
+    }
+
+    using column_indices = std::index_sequence_for<Ts...>;
+
+public:
+    using key_type = Key;
+    using key_index_type = decltype(slot_map_soa::get_index(std::declval<Key>()));
+    using key_generation_type = decltype(slot_map_soa::get_generation(std::declval<Key>()));
+    using size_type = size_t;
+
+    template<size_t I> using column_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+#if __cpp_lib_span >= 202002L
+    template<class T> using span = std::span<T>;
+#else
+    template<class T> using span = slot_map_detail::column_span<T>;
+#endif
+
+    static constexpr size_t column_count = sizeof...(Ts);
+
+    slot_map_soa() = default;
+
+    // The columns are contiguous and in the same order: column<I>()[i] and
+    // column<J>()[i] are components of the same value, whose key is key_at(i).
+    //
+    template<size_t I> span<column_type<I>> column() { auto& c = std::get<I>(columns_); return span<column_type<I>>(c.data(), c.size()); }
+    template<size_t I> span<const column_type<I>> column() const { auto& c = std::get<I>(columns_); return span<const column_type<I>>(c.data(), c.size()); }
+    template<class T> span<T> column() { return this->column<column_index<T>()>(); }
+    template<class T> span<const T> column() const { return this->column<column_index<T>()>(); }
+
+    // The key of the value at dense index i.
+    // O(1) time and space complexity.
+    //
+    key_type key_at(size_type i) const {
+        auto slot_index = reverse_map_[i];
+        key_type result = slots_[slot_index];
+        this->set_index(result, slot_index);
+        return result;
+    }
+
+    // index_of() has generation counter checking.
+    // If the check fails, it returns size().
+    // O(1) time and space complexity.
+    //
+    size_type index_of(const key_type& key) const {
+        auto slot_index = get_index(key);
+        if (slot_index >= slots_.size() || get_generation(slots_[slot_index]) != get_generation(key)) {
+            return this->size();
+        }
+        return get_index(slots_[slot_index]);
+    }
+    bool contains(const key_type& key) const { return this->index_of(key) != this->size(); }
+
+    // The find() functions have generation counter checking.
+    // If the check fails, they return nullptr.
+    // O(1) time and space complexity.
+    //
+    template<size_t I> column_type<I> *find(const key_type& key) {
+        size_type i = this->index_of(key);
+        return (i == this->size()) ? nullptr : &std::get<I>(columns_)[i];
+    }
+    template<size_t I> const column_type<I> *find(const key_type& key) const {
+        size_type i = this->index_of(key);
+        return (i == this->size()) ? nullptr : &std::get<I>(columns_)[i];
+    }
+    template<class T> T *find(const key_type& key) { return this->find<column_index<T>()>(key); }
+    template<class T> const T *find(const key_type& key) const { return this->find<column_index<T>()>(key); }
+
+    // The at() functions have both generation counter checking
+    // and bounds checking, and throw if either check fails.
+    // O(1) time and space complexity.
+    //
+    template<size_t I> column_type<I>& at(const key_type& key) {
+        auto *p = this->find<I>(key);
+        if (p == nullptr) {
+            SLOT_MAP_THROW_EXCEPTION(std::out_of_range, "at");
+        }
+        return *p;
+    }
+    template<size_t I> const column_type<I>& at(const key_type& key) const {
+        auto *p = this->find<I>(key);
+        if (p == nullptr) {
+            SLOT_MAP_THROW_EXCEPTION(std::out_of_range, "at");
+        }
+        return *p;
+    }
+    template<class T> T& at(const key_type& key) { return this->at<column_index<T>()>(key); }
+    template<class T> const T& at(const key_type& key) const { return this->at<column_index<T>()>(key); }
+
+    bool empty() const { return reverse_map_.empty(); }
+    size_type size() const { return reverse_map_.size(); }
+    size_type capacity() const { return reverse_map_.capacity(); }
+    size_type slot_count() const { return slots_.size(); }
+
+    void reserve(size_type n) {
+        std::apply([&](auto&... cols) { (cols.reserve(n), ...); }, columns_);
+        reverse_map_.reserve(n);
+        this->reserve_slots(n);
+    }
+
+    // Like slot_map's, these throw length_error if a key cannot hold the new slot's index.
+    //
+    void reserve_slots(size_type n) {
+        if (n > max_slot_count()) {
+            SLOT_MAP_THROW_EXCEPTION(std::length_error, "reserve_slots");
+        }
+        slots_.reserve(n);
+        key_index_type original_num_slots = static_cast<key_index_type>(slots_.size());
+        if (original_num_slots < n) {
+            slots_.emplace_back(key_type{next_available_slot_index_, key_generation_type{}});
+            key_index_type last_new_slot = original_num_slots;
+            --n;
+            while (last_new_slot != n) {
+                slots_.emplace_back(key_type{last_new_slot, key_generation_type{}});
+                ++last_new_slot;
+            }
+            next_available_slot_index_ = last_new_slot;
+        }
+    }
+
+    // Takes one constructor argument per column.
+    // If an exception is thrown, the values are unchanged.
+    // O(1) time and space complexity, amortized.
+    //
+    template<class... Us, class = std::enable_if_t<sizeof...(Us) == sizeof...(Ts)>>
+    key_type emplace(Us&&... us) {
+        if (reverse_map_.size() >= max_slot_count()) {
+            SLOT_MAP_THROW_EXCEPTION(std::length_error, "emplace");
+        }
+        if (next_available_slot_index_ == slots_.size()) {
+            // The new slot is the only one in the free list, so it stays valid
+            // even if constructing the components throws.
+            slots_.emplace_back(key_type{next_available_slot_index_, key_generation_type{}});  // make a new slot
+            last_available_slot_index_ = next_available_slot_index_;
+        }
+        reverse_map_.emplace_back(next_available_slot_index_);
+        this->emplace_columns(column_indices{}, static_cast<Us&&>(us)...);
+        auto value_pos = reverse_map_.size() - 1;
+        auto& slot = slots_[next_available_slot_index_];
+        key_index_type slot_index = next_available_slot_index_;
+        if (next_available_slot_index_ == last_available_slot_index_) {
+            next_available_slot_index_ = static_cast<key_index_type>(slots_.size());
+            last_available_slot_index_ = next_available_slot_index_;
+        } else {
+            next_available_slot_index_ = this->get_index(slot);
+        }
+        this->set_index(slot, value_pos);
+        key_type result = slot;
+        this->set_index(result, slot_index);
+        return result;
+    }
+    key_type insert(const Ts&... values) { return this->emplace(values...); }
+    key_type insert(Ts&&... values) { return this->emplace(static_cast<Ts&&>(values)...); }
+
+    // Moves the last value's components into the erased value's place in every column.
+    // O(1) time and space complexity.
+    //
+    size_type erase(const key_type& key) {
+        size_type i = this->index_of(key);
+        if (i == this->size()) {
+            return 0;
+        }
+        this->erase_index(i);
+        return 1;
+    }
+    void erase_index(size_type i) {
+        key_index_type slot_index = reverse_map_[i];
+        size_type last = reverse_map_.size() - 1;
+        this->move_columns(i, last, column_indices{});
+        if (i != last) {
+            reverse_map_[i] = reverse_map_[last];
+            this->set_index(slots_[reverse_map_[i]], i);
+        }
+        reverse_map_.pop_back();
+        // Expire this key.
+        if (next_available_slot_index_ == slots_.size()) {
+            next_available_slot_index_ = slot_index;
+            last_available_slot_index_ = slot_index;
+        } else {
+            this->set_index(slots_[last_available_slot_index_], slot_index);
+            last_available_slot_index_ = slot_index;
+        }
+        this->increment_generation(slots_[slot_index]);
+    }
+
+    // Like slot_map::clear, this resets the generation counters.
+    //
+    void clear() {
+        slots_.clear();
+        reverse_map_.clear();
+        std::apply([](auto&... cols) { (cols.clear(), ...); }, columns_);
+        next_available_slot_index_ = key_index_type{};
+        last_available_slot_index_ = key_index_type{};
+    }
+
+    void swap(slot_map_soa& rhs) {
+        using std::swap;
+        swap(slots_, rhs.slots_);
+        swap(reverse_map_, rhs.reverse_map_);
+        swap(columns_, rhs.columns_);
+        swap(next_available_slot_index_, rhs.next_available_slot_index_);
+        swap(last_available_slot_index_, rhs.last_available_slot_index_);
+    }
+    friend void swap(slot_map_soa& lhs, slot_map_soa& rhs) { lhs.swap(rhs); }
+
+private:
+    static constexpr size_type max_slot_count() {
+        return static_cast<size_type>(slot_map_detail::max_key_index<key_traits, key_index_type>(slot_map_detail::priority_tag<1>{}));
+    }
+
+    // Unless complete() is called, pops the reverse map entry and the first done_
+    // columns' components, so that a throwing constructor leaves the values unchanged.
+    struct emplace_rollback_guard {
+        slot_map_soa *self_;
+        size_t done_ = 0;
+        explicit emplace_rollback_guard(slot_map_soa *self) : self_(self) {}
+        void complete() {
+            self_ = nullptr;
+        }
+        ~emplace_rollback_guard() {
+            if (self_ != nullptr) {
+                self_->pop_columns(done_, column_indices{});
+                self_->reverse_map_.pop_back();
+            }
+        }
+    };
+
+    template<size_t... Is, class... Us>
+    void emplace_columns(std::index_sequence<Is...>, Us&&... us) {
+        emplace_rollback_guard guard(this);
+        ((std::get<Is>(columns_).emplace_back(static_cast<Us&&>(us)), ++guard.done_), ...);
+        guard.complete();
+    }
+
+    template<size_t... Is>
+    void pop_columns(size_t n, std::index_sequence<Is...>) {
+        ((Is < n ? std::get<Is>(columns_).pop_back() : void()), ...);
+    }
+
+    template<size_t... Is>
+    void move_columns(size_type i, size_type last, std::index_sequence<Is...>) {
+        auto move_one = [&](auto& col) {
+            if (i != last) {
+                col[i] = std::move(col[last]);
+            }
+            col.pop_back();
+        };
+        (move_one(std::get<Is>(columns_)), ...);
+    }
+
+    std::vector<key_type> slots_;  // high_water_mark() entries
+    std::vector<key_index_type> reverse_map_;  // exactly size() entries
+    std::tuple<std::vector<Ts>...> columns_;  // exactly size() entries each
+    key_index_type next_available_slot_index_{};
+    key_index_type last_available_slot_index_{};
+
+    // Class invariant: the same as slot_map's.
+};
+
+} // namespace sg14
@@ -0,0 +1,110 @@
+#include <sg14/chunked_vector.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+TEST(chunked_vector, ChunkSize)
+{
+    static_assert(sg14::chunked_vector<char>::chunk_size == 16384, "");
+    static_assert(sg14::chunked_vector<int>::chunk_size == 4096, "");
+    static_assert(sg14::chunked_vector<char[3]>::chunk_size == 4096, "");
+    static_assert(sg14::chunked_vector<char[20000]>::chunk_size == 1, "");
+    using It = sg14::chunked_vector<int>::iterator;
+    static_assert(std::is_same<std::iterator_traits<It>::iterator_category, std::random_access_iterator_tag>::value, "");
+    static_assert(std::is_convertible<It, sg14::chunked_vector<int>::const_iterator>::value, "");
+    static_assert(!std::is_convertible<sg14::chunked_vector<int>::const_iterator, It>::value, "");
+#if __cpp_lib_ranges >= 201911L
+    static_assert(std::random_access_iterator<It>);
+#endif
+}
+
+TEST(chunked_vector, Basic)
+{
+    sg14::chunked_vector<int> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), 0u);
+    for (int i = 0; i < 10000; ++i) {
+        v.push_back(i);
+    }
+    EXPECT_EQ(v.size(), 10000u);
+    EXPECT_EQ(v.capacity(), 3 * v.chunk_size);
+    EXPECT_EQ(v.front(), 0);
+    EXPECT_EQ(v.back(), 9999);
+    EXPECT_EQ(v[4096], 4096);
+    EXPECT_EQ(v.at(9000), 9000);
+    EXPECT_THROW(v.at(10000), std::out_of_range);
+    EXPECT_EQ(v.end() - v.begin(), 10000);
+    EXPECT_TRUE(std::is_sorted(v.begin(), v.end()));
+    EXPECT_EQ(*std::lower_bound(v.begin(), v.end(), 5000), 5000);
+    EXPECT_EQ(*v.rbegin(), 9999);
+    EXPECT_EQ(std::count_if(v.cbegin(), v.cend(), [](int i) { return i % 2 == 0; }), 5000);
+
+    v.pop_back();
+    EXPECT_EQ(v.back(), 9998);
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), 3 * v.chunk_size);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 0u);
+}
+
+TEST(chunked_vector, ReferencesAreStable)
+{
+    sg14::chunked_vector<std::string> v;
+    v.emplace_back("hello");
+    std::string *p = &v[0];
+    const char *data = v[0].data();
+    for (int i = 0; i < 100000; ++i) {
+        v.emplace_back(std::to_string(i));
+    }
+    EXPECT_EQ(p, &v[0]);
+    EXPECT_EQ(data, v[0].data());
+    EXPECT_EQ(v[100000], "99999");
+    v.reserve(300000);
+    EXPECT_EQ(p, &v[0]);
+    EXPECT_GE(v.capacity(), 300000u);
+}
+
+TEST(chunked_vector, CopyMoveSwap)
+{
+    sg14::chunked_vector<std::string> v = {"a", "b", "c"};
+    auto w = v;
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), w.begin(), w.end()));
+    auto m = std::move(w);
+    EXPECT_TRUE(w.empty());
+    EXPECT_EQ(m.size(), 3u);
+    w = m;
+    EXPECT_EQ(w.size(), 3u);
+    m.emplace_back("d");
+    w = std::move(m);
+    EXPECT_EQ(w.size(), 4u);
+    EXPECT_EQ(w.back(), "d");
+    swap(v, w);
+    EXPECT_EQ(v.size(), 4u);
+    EXPECT_EQ(w.size(), 3u);
+
+    std::vector<int> src(5000, 42);
+    sg14::chunked_vector<int> c(src.begin(), src.end());
+    EXPECT_EQ(c.size(), 5000u);
+    EXPECT_TRUE(std::equal(c.begin(), c.end(), src.begin(), src.end()));
+}
+
+TEST(chunked_vector, MoveOnly)
+{
+    sg14::chunked_vector<std::unique_ptr<int>> v;
+    for (int i = 0; i < 5000; ++i) {
+        v.emplace_back(std::make_unique<int>(i));
+    }
+    auto w = std::move(v);
+    EXPECT_EQ(*w[4999], 4999);
+    v = std::move(w);
+    EXPECT_EQ(*v[0], 0);
+    static_assert(std::is_nothrow_move_constructible<sg14::chunked_vector<std::unique_ptr<int>>>::value, "");
+    static_assert(std::is_nothrow_move_assignable<sg14::chunked_vector<std::unique_ptr<int>>>::value, "");
+}
@@ -0,0 +1,177 @@
+#include <sg14/concurrent_slot_map.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Counted {
+    explicit Counted(int v, int *live) : value(v), live_(live) { ++*live_; }
+    Counted(const Counted&) = delete;
+    ~Counted() { --*live_; }
+    int value;
+    int *live_;
+};
+
+} // namespace
+
+TEST(concurrent_slot_map, Basic)
+{
+    sg14::concurrent_slot_map<std::string> sm;
+    auto reader = sm.make_reader();
+    auto k1 = sm.insert("hello");
+    auto k2 = sm.emplace(3, 'x');
+    EXPECT_EQ(sm.size(), 2u);
+    EXPECT_EQ(*sm.find(k1), "hello");
+    EXPECT_EQ(*sm.find(k2), "xxx");
+
+    std::string seen;
+    EXPECT_TRUE(reader.read(k1, [&](const std::string& s) { seen = s; }));
+    EXPECT_EQ(seen, "hello");
+
+    EXPECT_TRUE(sm.replace(k1, "world"));
+    EXPECT_TRUE(reader.read(k1, [&](const std::string& s) { seen = s; }));
+    EXPECT_EQ(seen, "world");
+
+    EXPECT_EQ(sm.erase(k1), 1u);
+    EXPECT_EQ(sm.erase(k1), 0u);
+    EXPECT_FALSE(sm.replace(k1, "stale"));
+    EXPECT_FALSE(reader.read(k1, [&](const std::string&) {}));
+    EXPECT_EQ(sm.find(k1), nullptr);
+
+    // The reused slot has a new generation.
+    auto k3 = sm.insert("again");
+    EXPECT_EQ(k3.first, k1.first);
+    EXPECT_NE(k3.second, k1.second);
+    EXPECT_FALSE(reader.pin().contains(k1));
+    EXPECT_TRUE(reader.pin().contains(k3));
+
+    // clear() keeps the generations, so old keys stay stale.
+    sm.clear();
+    EXPECT_TRUE(sm.empty());
+    auto k4 = sm.insert("fresh");
+    EXPECT_FALSE(reader.pin().contains(k3));
+    EXPECT_FALSE(reader.pin().contains(k2));
+    EXPECT_TRUE(reader.pin().contains(k4));
+
+    int n = 0;
+    sm.for_each([&](const sg14::concurrent_slot_map<std::string>::key_type& k, const std::string& s) {
+        EXPECT_EQ(k, k4);
+        EXPECT_EQ(s, "fresh");
+        ++n;
+    });
+    EXPECT_EQ(n, 1);
+}
+
+TEST(concurrent_slot_map, Readers)
+{
+    sg14::concurrent_slot_map<int> sm(2);
+    auto r1 = sm.make_reader();
+    {
+        auto r2 = sm.make_reader();
+        EXPECT_THROW(sm.make_reader(), std::length_error);
+        auto r3 = std::move(r2);
+    }
+    auto r2 = sm.make_reader();
+    auto k = sm.insert(42);
+    auto guard = r1.pin();
+    EXPECT_EQ(*guard.find(k), 42);
+    auto guard2 = r1.pin();  // pins nest
+    EXPECT_EQ(*guard2.find(k), 42);
+}
+
+TEST(concurrent_slot_map, PinnedValuesSurvive)
+{
+    int live = 0;
+    {
+        sg14::concurrent_slot_map<Counted> sm;
+        auto reader = sm.make_reader();
+        auto k = sm.emplace(1, &live);
+        {
+            auto guard = reader.pin();
+            const Counted *p = guard.find(k);
+            EXPECT_TRUE(sm.replace(k, 2, &live));
+            EXPECT_EQ(guard.find(k)->value, 2);
+            sm.erase(k);
+            EXPECT_EQ(guard.find(k), nullptr);
+            sm.reclaim();
+            EXPECT_EQ(p->value, 1);
+            EXPECT_EQ(live, 2);
+        }
+        sm.reclaim();
+        EXPECT_EQ(live, 0);
+        for (int i = 0; i < 1000; ++i) {
+            sm.erase(sm.emplace(i, &live));
+        }
+        EXPECT_LE(live, 64);
+        sm.emplace(1, &live);
+    }
+    EXPECT_EQ(live, 0);
+}
+
+TEST(concurrent_slot_map, PackedKey)
+{
+    sg14::concurrent_slot_map<int, sg14::packed_key<16, 8, 8>> sm;
+    auto reader = sm.make_reader();
+    auto k = sm.insert(7);
+    auto tagged = k;
+    tagged.set_tag(200);
+    int seen = 0;
+    EXPECT_TRUE(reader.read(tagged, [&](int v) { seen = v; }));
+    EXPECT_EQ(seen, 7);
+}
+
+TEST(concurrent_slot_map, SingleWriterManyReaders)
+{
+    // Each value is a pair (n, -n); a reader must never see a torn or freed value.
+    struct Pair { long a; long b; };
+    using SM = sg14::concurrent_slot_map<Pair>;
+    SM sm;
+    std::vector<SM::key_type> keys;
+    for (long i = 0; i < 1000; ++i) {
+        keys.push_back(sm.insert(Pair{i, -i}));
+    }
+    std::vector<SM::key_type> snapshot = keys;
+
+    std::atomic<bool> done{false};
+    std::atomic<long> bad{0};
+    std::atomic<long> hits{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&, reader = sm.make_reader()]() {
+            while (!done.load()) {
+                long h = 0;
+                for (const auto& k : snapshot) {
+                    reader.read(k, [&](const Pair& p) {
+                        h += 1;
+                        if (p.a != -p.b) {
+                            bad.fetch_add(1);
+                        }
+                    });
+                }
+                hits.fetch_add(h);
+            }
+        });
+    }
+    for (long round = 1; round <= 200; ++round) {
+        for (size_t i = 0; i < keys.size(); i += 7) {
+            sm.replace(keys[i], Pair{round, -round});
+        }
+        for (size_t i = round % 5; i < keys.size(); i += 5) {
+            sm.erase(keys[i]);
+            keys[i] = sm.insert(Pair{-round, round});
+        }
+    }
+    done.store(true);
+    for (auto&& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(bad.load(), 0);
+    EXPECT_EQ(sm.size(), 1000u);
+}
@@ -0,0 +1,110 @@
+#include <sg14/eytzinger_flat_set.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+template<class T> struct eytzinger_flat_sett : testing::Test {};
+
+using eytzinger_flat_sett_types = testing::Types<
+    sg14::eytzinger_flat_set<int>                                        // basic
+    , sg14::eytzinger_flat_set<int, std::greater<int>>                   // custom comparator
+    , sg14::eytzinger_flat_set<int, std::greater<>>                      // transparent comparator
+    , sg14::eytzinger_flat_set<int, std::less<int>, std::deque<int>>     // custom container
+>;
+TYPED_TEST_SUITE(eytzinger_flat_sett, eytzinger_flat_sett_types);
+
+TYPED_TEST(eytzinger_flat_sett, LowerBound)
+{
+    using FS = TypeParam;
+    using Compare = typename FS::key_compare;
+    for (int n = 0; n < 70; ++n) {
+        std::vector<int> sorted;
+        for (int i = 0; i < n; ++i) {
+            sorted.push_back(2 * i);
+        }
+        std::sort(sorted.begin(), sorted.end(), Compare());
+        FS fs(sg14::sorted_unique, typename FS::container_type(sorted.begin(), sorted.end()));
+        EXPECT_EQ(fs.size(), size_t(n));
+        for (int k = -1; k <= 2 * n; ++k) {
+            auto expected = std::lower_bound(sorted.begin(), sorted.end(), k, Compare());
+            auto it = fs.lower_bound(k);
+            if (expected == sorted.end()) {
+                EXPECT_EQ(it, fs.end());
+            } else {
+                ASSERT_NE(it, fs.end());
+                EXPECT_EQ(*it, *expected);
+            }
+            bool present = (k >= 0 && k % 2 == 0 && k < 2 * n);
+            EXPECT_EQ(fs.contains(k), present);
+            EXPECT_EQ(fs.count(k), present ? 1u : 0u);
+            EXPECT_EQ(fs.find(k) != fs.end(), present);
+        }
+        EXPECT_EQ(std::move(fs).extract(), typename FS::container_type(sorted.begin(), sorted.end()));
+        EXPECT_TRUE(fs.empty());
+    }
+}
+
+TYPED_TEST(eytzinger_flat_sett, Construction)
+{
+    using FS = TypeParam;
+    using C = typename FS::container_type;
+    int a[] = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+    FS fs1(a, a + 11);
+    FS fs2 = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+    FS fs3(C(a, a + 11));
+    FS fs4;
+    fs4.replace(C(a, a + 11));
+    EXPECT_EQ(fs1.size(), 7u);
+    EXPECT_EQ(fs1, fs2);
+    EXPECT_EQ(fs1, fs3);
+    EXPECT_EQ(fs1, fs4);
+    EXPECT_TRUE(std::is_permutation(fs1.begin(), fs1.end(), C{1, 2, 3, 4, 5, 6, 9}.begin()));
+    fs4 = {1, 2};
+    EXPECT_NE(fs1, fs4);
+    fs1.swap(fs4);
+    EXPECT_EQ(fs1.size(), 2u);
+    EXPECT_TRUE(fs4.contains(9));
+    fs4.clear();
+    EXPECT_TRUE(fs4.empty());
+    EXPECT_EQ(fs4.find(9), fs4.end());
+}
+
+TEST(eytzinger_flat_set, Layout)
+{
+    // The root is the median; the leftmost leaf is the minimum.
+    sg14::eytzinger_flat_set<int> fs = {1, 2, 3, 4, 5, 6, 7};
+    std::vector<int> expected = {4, 2, 6, 1, 3, 5, 7};
+    EXPECT_EQ(fs.keys(), expected);
+    fs = {1, 2, 3, 4, 5, 6};
+    expected = {4, 2, 6, 1, 3, 5};
+    EXPECT_EQ(fs.keys(), expected);
+}
+
+TEST(eytzinger_flat_set, MoveOnlyAndTransparent)
+{
+    std::vector<std::string> v = {"delta", "alpha", "echo", "charlie", "bravo"};
+    sg14::eytzinger_flat_set<std::string, std::less<>> fs(std::move(v));
+    EXPECT_TRUE(fs.contains("charlie"));
+    EXPECT_FALSE(fs.contains("foxtrot"));
+    EXPECT_EQ(*fs.lower_bound("c"), "charlie");
+    EXPECT_EQ(fs.lower_bound("f"), fs.end());
+
+    std::vector<std::unique_ptr<int>> ptrs;
+    for (int i = 0; i < 20; ++i) {
+        ptrs.push_back(std::make_unique<int>(i));
+    }
+    auto by_value = [](const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) { return *a < *b; };
+    sg14::eytzinger_flat_set<std::unique_ptr<int>, decltype(by_value)> ps(sg14::sorted_unique, std::move(ptrs), by_value);
+    auto key = std::make_unique<int>(13);
+    EXPECT_EQ(**ps.find(key), 13);
+    auto sorted = std::move(ps).extract();
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(*sorted[i], i);
+    }
+}
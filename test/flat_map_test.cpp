@@ -2,12 +2,14 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <deque>
 #include <functional>
 #include <list>
 #if __has_include(<memory_resource>)
 #include <memory_resource>
 #endif
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -253,6 +255,524 @@ TEST(flat_map, TryEmplace)
     }
 }
 
+TEST(flat_map, EmplaceHint)
+{
+    int comparisons = 0;
+    auto counting_less = [&](int a, int b) { ++comparisons; return a < b; };
+    using FM = sg14::flat_map<int, char, decltype(counting_less)>;
+    FM fm(counting_less);
+    for (int i = 0; i < 100; i += 2) {
+        fm.emplace(i, 'x');
+    }
+
+    // A correct hint costs at most two comparisons, no matter the size of the map.
+    comparisons = 0;
+    auto it = fm.emplace_hint(fm.begin() + 25, 49, 'a');
+    EXPECT_LE(comparisons, 2);
+    EXPECT_EQ(it, fm.begin() + 25);
+    EXPECT_EQ(it->first, 49);
+    EXPECT_EQ(it->second, 'a');
+    comparisons = 0;
+    it = fm.emplace_hint(fm.end(), 100, 'b');
+    EXPECT_LE(comparisons, 2);
+    EXPECT_EQ(it, fm.end() - 1);
+    comparisons = 0;
+    it = fm.emplace_hint(fm.begin(), -1, 'c');
+    EXPECT_LE(comparisons, 2);
+    EXPECT_EQ(it, fm.begin());
+    EXPECT_EQ(fm.size(), 53u);
+
+    // A hint adjacent to an existing equal key finds it, and doesn't insert.
+    it = fm.emplace_hint(fm.begin() + 3, 4, 'd');
+    EXPECT_EQ(it, fm.begin() + 3);
+    EXPECT_EQ(it->second, 'x');
+    it = fm.emplace_hint(fm.begin() + 4, 4, 'd');
+    EXPECT_EQ(it, fm.begin() + 3);
+    EXPECT_EQ(it->second, 'x');
+
+    // Incorrect hints, on either side, still do the right thing.
+    it = fm.emplace_hint(fm.begin(), 51, 'e');
+    EXPECT_EQ(it->first, 51);
+    EXPECT_EQ(it->second, 'e');
+    it = fm.emplace_hint(fm.end(), 3, 'f');
+    EXPECT_EQ(it->first, 3);
+    EXPECT_EQ(it->second, 'f');
+    it = fm.emplace_hint(fm.begin(), 98, 'g');
+    EXPECT_EQ(it->first, 98);
+    EXPECT_EQ(it->second, 'x');
+    it = fm.insert(fm.end(), std::make_pair(0, 'h'));
+    EXPECT_EQ(it, fm.begin() + 1);
+    EXPECT_EQ(it->second, 'x');
+    EXPECT_EQ(fm.size(), 55u);
+    EXPECT_TRUE(std::is_sorted(fm.keys().begin(), fm.keys().end()));
+
+    // Appending almost-sorted keys with end() as the hint.
+    FM fm2(counting_less);
+    for (int i : {1, 2, 4, 3, 5, 7, 6, 8, 9, 9, 10}) {
+        fm2.emplace_hint(fm2.end(), i, 'x');
+    }
+    EXPECT_EQ(fm2.size(), 10u);
+    EXPECT_TRUE(std::is_sorted(fm2.keys().begin(), fm2.keys().end()));
+}
+
+TEST(flat_map, InsertSortedUnique)
+{
+    sg14::flat_map<int, char> fm = {{2,'a'}, {4,'a'}, {6,'a'}, {8,'a'}};
+    std::pair<int, char> pairs[] = {{0,'b'}, {1,'b'}, {4,'b'}, {5,'b'}, {8,'b'}, {9,'b'}, {10,'b'}};
+    fm.insert(sg14::sorted_unique, pairs, pairs + 7);
+    std::vector<int> expected_keys = {0, 1, 2, 4, 5, 6, 8, 9, 10};
+    std::vector<char> expected_values = {'b', 'b', 'a', 'a', 'b', 'a', 'a', 'b', 'b'};
+    EXPECT_EQ(fm.keys(), expected_keys);
+    EXPECT_EQ(fm.values(), expected_values);
+
+    fm.insert(sg14::sorted_unique, pairs, pairs);
+    EXPECT_EQ(fm.keys(), expected_keys);
+    fm.insert(sg14::sorted_unique, {{0,'c'}, {10,'c'}});
+    EXPECT_EQ(fm.keys(), expected_keys);
+    EXPECT_EQ(fm.values(), expected_values);
+
+    sg14::flat_map<int, std::unique_ptr<int>, std::greater<int>> fm2;
+    std::vector<std::pair<int, std::unique_ptr<int>>> v;
+    v.emplace_back(5, std::make_unique<int>(5));
+    v.emplace_back(3, std::make_unique<int>(3));
+    fm2.insert(sg14::sorted_unique, std::make_move_iterator(v.begin()), std::make_move_iterator(v.end()));
+    v.clear();
+    v.emplace_back(6, std::make_unique<int>(6));
+    v.emplace_back(5, std::make_unique<int>(50));
+    v.emplace_back(4, std::make_unique<int>(4));
+    v.emplace_back(1, std::make_unique<int>(1));
+    fm2.insert(sg14::sorted_unique, std::make_move_iterator(v.begin()), std::make_move_iterator(v.end()));
+    EXPECT_EQ(fm2.size(), 5u);
+    expected_keys = {6, 5, 4, 3, 1};
+    EXPECT_EQ(fm2.keys(), expected_keys);
+    for (auto&& kv : fm2) {
+        EXPECT_EQ(*kv.second, kv.first);
+    }
+}
+
+namespace {
+
+template<class FM>
+void check_arithmetic_lower_bound(typename FM::key_type lo, typename FM::key_type step)
+{
+    using Key = typename FM::key_type;
+    for (int n = 0; n < 100; ++n) {
+        FM fm;
+        for (int i = 0; i < n; ++i) {
+            fm.emplace(Key(lo + step * Key(2 * i)), i);
+        }
+        const FM& cfm = fm;
+        for (int i = -1; i <= 2 * n; ++i) {
+            Key k = Key(lo + step * Key(i));
+            auto expected = std::lower_bound(fm.keys().begin(), fm.keys().end(), k) - fm.keys().begin();
+            EXPECT_EQ(fm.lower_bound(k) - fm.begin(), expected);
+            EXPECT_EQ(cfm.lower_bound(k) - cfm.begin(), expected);
+            EXPECT_EQ(fm.equal_range(k).first - fm.begin(), expected);
+            EXPECT_EQ(cfm.equal_range(k).second - cfm.begin(), expected + (i >= 0 && i % 2 == 0 && i < 2 * n));
+            EXPECT_EQ(fm.contains(k), (i >= 0 && i % 2 == 0 && i < 2 * n));
+        }
+    }
+}
+
+} // namespace
+
+TEST(flat_map, ArithmeticLowerBound)
+{
+    check_arithmetic_lower_bound<sg14::flat_map<int, int>>(-50, 1);
+    check_arithmetic_lower_bound<sg14::flat_map<int, int, std::less<>>>(-50, 1);
+    check_arithmetic_lower_bound<sg14::flat_map<unsigned, int>>(0x7FFFFFC0u, 1);
+    check_arithmetic_lower_bound<sg14::flat_map<unsigned char, int>>(0, 1);
+    check_arithmetic_lower_bound<sg14::flat_map<long long, int>>(-(1LL << 40), 1LL << 33);
+    check_arithmetic_lower_bound<sg14::flat_map<float, int>>(-2.5f, 0.25f);
+    check_arithmetic_lower_bound<sg14::flat_map<double, int, std::less<double>, std::deque<double>>>(-2.5, 0.25);
+
+    sg14::flat_map<unsigned, char> fm;
+    auto result = fm.try_emplace(0xFFFFFFFFu, 'a');
+    EXPECT_TRUE(result.second);
+    result = fm.try_emplace(0u, 'b');
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(result.first, fm.begin());
+    result = fm.try_emplace(0xFFFFFFFFu, 'c');
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(result.first->second, 'a');
+    EXPECT_EQ(fm.find(0x80000000u), fm.end());
+}
+
+TEST(flat_map, FindMany)
+{
+    sg14::flat_map<int, char> fm;
+    std::vector<int> queries = {5, 3, 9, -1, 0, 5};
+    std::vector<sg14::flat_map<int, char>::iterator> its(queries.size());
+    EXPECT_EQ(fm.find_many(queries.begin(), queries.end(), its.begin()), its.end());
+    for (auto it : its) {
+        EXPECT_EQ(it, fm.end());
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        fm.emplace(i, char('a' + i % 26));
+    }
+    queries.clear();
+    for (int i = 0; i < 500; ++i) {
+        queries.push_back((i * 7919) % 1010 - 5);
+    }
+    auto check = [&](const sg14::flat_map<int, char>& cfm) {
+        std::vector<sg14::flat_map<int, char>::const_iterator> cits;
+        cfm.find_many(queries.begin(), queries.end(), std::back_inserter(cits));
+        std::vector<bool> found;
+        cfm.contains_many(queries.begin(), queries.end(), std::back_inserter(found));
+        ASSERT_EQ(cits.size(), queries.size());
+        ASSERT_EQ(found.size(), queries.size());
+        for (size_t i = 0; i < queries.size(); ++i) {
+            EXPECT_EQ(cits[i], cfm.find(queries[i]));
+            EXPECT_EQ(found[i], cfm.contains(queries[i]));
+        }
+    };
+    check(fm);
+    std::sort(queries.begin(), queries.end());
+    check(fm);
+    its.resize(queries.size());
+    fm.find_many(queries.begin(), queries.end(), its.begin());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(its[i], fm.find(queries[i]));
+    }
+
+    sg14::flat_map<std::string, int, std::greater<>, std::deque<std::string>> fm2 = {{"a", 1}, {"b", 2}, {"c", 3}};
+    const char *words[] = {"c", "d", "a"};
+    bool contained[3] = {};
+    fm2.contains_many(words, words + 3, contained);
+    EXPECT_TRUE(contained[0]);
+    EXPECT_FALSE(contained[1]);
+    EXPECT_TRUE(contained[2]);
+}
+
+TEST(flat_map, SortedRuns)
+{
+    int comparisons = 0;
+    auto counting_less = [&](int a, int b) { ++comparisons; return a < b; };
+    using FM = sg14::flat_map<int, int, decltype(counting_less)>;
+
+    // Already-sorted input should be validated and deduplicated in linear time.
+    std::vector<int> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(i / 2);
+    }
+    std::vector<int> values = keys;
+    FM fm(counting_less);
+    fm.replace(keys, values);
+    EXPECT_EQ(fm.size(), 500u);
+    EXPECT_LE(comparisons, 2010);
+
+    // So should reverse-sorted input.
+    std::reverse(keys.begin(), keys.end());
+    comparisons = 0;
+    fm.replace(keys, values);
+    EXPECT_EQ(fm.size(), 500u);
+    EXPECT_LE(comparisons, 2010);
+
+    auto check = [](const std::vector<int>& ks, int expected_size) {
+        std::vector<int> vs;
+        for (int k : ks) {
+            vs.push_back(k * 10);
+        }
+        sg14::flat_map<int, int> m;
+        m.replace(ks, vs);
+        EXPECT_EQ(m.size(), size_t(expected_size));
+        EXPECT_TRUE(std::is_sorted(m.keys().begin(), m.keys().end()));
+        for (auto&& kv : m) {
+            EXPECT_EQ(kv.second, kv.first * 10);
+        }
+    };
+    // Several sorted runs appended together.
+    keys.clear();
+    for (int run = 0; run < 5; ++run) {
+        for (int i = 0; i < 300; ++i) {
+            keys.push_back(i * 5 + run);
+        }
+    }
+    check(keys, 1500);
+    // Mostly sorted, with a few elements out of place.
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i + 7 < keys.size(); i += 97) {
+        std::swap(keys[i], keys[i + 7]);
+    }
+    check(keys, 1500);
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i < 30; ++i) {
+        std::swap(keys[(i * 7919) % keys.size()], keys[(i * 104729) % keys.size()]);
+    }
+    std::swap(keys[100], keys[1000]);
+    std::swap(keys[101], keys[1001]);
+    check(keys, 1500);
+    // Short runs and pseudo-random input.
+    keys.clear();
+    for (int i = 0; i < 2000; ++i) {
+        keys.push_back((i * 7919) % 1009);
+    }
+    check(keys, 1009);
+    check({3, 2, 1, 1, 2, 3, 3, 2, 1}, 3);
+    check({}, 0);
+    check({42}, 1);
+}
+
+TEST(flat_map, SortThreads)
+{
+    std::vector<int> keys;
+    std::vector<int> values;
+    for (int i = 0; i < 100000; ++i) {
+        keys.push_back((i * 7919) % 65521);
+        values.push_back(keys.back() * 10);
+    }
+    for (size_t threads : {0, 1, 3, 8}) {
+        sg14::flat_map<int, int> fm;
+        fm.replace(sg14::sort_threads(threads), keys, values);
+        EXPECT_EQ(fm.size(), 65521u);
+        EXPECT_TRUE(std::is_sorted(fm.keys().begin(), fm.keys().end()));
+        for (auto&& kv : fm) {
+            EXPECT_EQ(kv.second, kv.first * 10);
+        }
+    }
+
+    std::vector<std::pair<std::string, int>> pairs;
+    for (int i = 0; i < 20000; ++i) {
+        pairs.emplace_back(std::to_string(i % 9973), i % 9973);
+    }
+    sg14::flat_map<std::string, int, std::greater<>> fm2(sg14::sort_threads(4), pairs.begin(), pairs.end());
+    EXPECT_EQ(fm2.size(), 9973u);
+    EXPECT_TRUE(std::is_sorted(fm2.keys().begin(), fm2.keys().end(), std::greater<>()));
+    for (auto&& kv : fm2) {
+        EXPECT_EQ(kv.first, std::to_string(kv.second));
+    }
+}
+
+TEST(flat_map, SortThreadsThrows)
+{
+    // An exception thrown on a worker thread reaches the caller,
+    // and the flat_map is left empty.
+    auto less = [](int a, int b) {
+        if (a == 12345 || b == 12345) {
+            throw std::runtime_error("oops");
+        }
+        return a < b;
+    };
+    std::vector<int> keys;
+    std::vector<int> values;
+    for (int i = 0; i < 100000; ++i) {
+        keys.push_back((i * 7919) % 65521);
+        values.push_back(i);
+    }
+    sg14::flat_map<int, int, decltype(less)> fm(less);
+    fm.insert_or_assign(1, 1);
+    ASSERT_THROW(fm.replace(sg14::sort_threads(4), keys, values), std::runtime_error);
+    EXPECT_TRUE(fm.empty());
+    EXPECT_TRUE(fm.keys().empty() && fm.values().empty());
+}
+
+TEST(flat_map, Interleaved)
+{
+    using IM = sg14::interleaved_flat_map<unsigned, unsigned short>;
+    IM im = {{3, 30}, {1, 10}, {2, 20}, {1, 11}};
+    EXPECT_EQ(im.size(), 3u);
+    EXPECT_EQ(im.at(1), 10);
+    EXPECT_EQ(im.begin()->first, 1u);
+    EXPECT_EQ((im.end() - 1)->second, 30);
+    EXPECT_THROW(im.at(4), std::out_of_range);
+
+    // Cross several block boundaries, comparing against flat_map as we go.
+    sg14::flat_map<unsigned, unsigned short> fm(im.begin(), im.end());
+    for (unsigned i = 0; i < 1000; ++i) {
+        unsigned k = (i * 7919) % 211;
+        if (i % 3 == 2) {
+            EXPECT_EQ(im.erase(k), fm.erase(k));
+        } else if (i % 3 == 1) {
+            EXPECT_EQ(im.insert_or_assign(k, i).second, fm.insert_or_assign(k, i).second);
+        } else {
+            EXPECT_EQ(im.try_emplace(k, i).second, fm.try_emplace(k, i).second);
+        }
+        ASSERT_EQ(im.size(), fm.size());
+        EXPECT_GE(im.capacity(), im.size());
+        EXPECT_LT(im.capacity(), im.size() + IM::block_size);
+    }
+    EXPECT_TRUE(std::equal(im.begin(), im.end(), fm.begin(), fm.end()));
+    for (unsigned k = 0; k < 220; ++k) {
+        EXPECT_EQ(im.contains(k), fm.contains(k));
+        EXPECT_EQ(im.lower_bound(k) - im.begin(), fm.lower_bound(k) - fm.begin());
+        EXPECT_EQ(im.upper_bound(k) - im.begin(), fm.upper_bound(k) - fm.begin());
+        auto er = im.equal_range(k);
+        auto fr = fm.equal_range(k);
+        EXPECT_EQ(er.first - im.begin(), fr.first - fm.begin());
+        EXPECT_EQ(er.second - im.begin(), fr.second - fm.begin());
+    }
+    im[500] = 5;
+    EXPECT_EQ(im.rbegin()->first, 500u);
+    EXPECT_EQ(im.rbegin()->second, 5);
+    for (auto it = im.begin(); it != im.end(); ) {
+        it = (it->first % 2 == 0) ? im.erase(it) : it + 1;
+    }
+    EXPECT_TRUE(std::all_of(im.begin(), im.end(), [](const auto& kv) { return kv.first % 2 == 1; }));
+
+    // Keys that arrive in order make end() a correct hint every time.
+    IM im2;
+    for (unsigned k = 0; k < 100; ++k) {
+        EXPECT_EQ(im2.emplace_hint(im2.end(), k, k)->first, k);
+    }
+    EXPECT_EQ(im2.emplace_hint(im2.begin(), 50u, 0)->second, 50);
+    EXPECT_EQ(im2.insert(im2.begin() + 10, {1000u, 7})->first, 1000u);
+    EXPECT_EQ((im2.end() - 1)->second, 7);
+    im2.erase(im2.end() - 1);
+    auto it = im2.erase(im2.begin() + 5, im2.begin() + 37);
+    EXPECT_EQ(it->first, 37u);
+    EXPECT_EQ(im2.size(), 68u);
+    EXPECT_LT(im2.capacity(), im2.size() + IM::block_size);
+    EXPECT_EQ((im2.begin() + 4)->first, 4u);
+    EXPECT_EQ(im2.erase(im2.begin() + 10, im2.begin() + 10), im2.begin() + 10);
+    im2.erase(im2.begin(), im2.end());
+    EXPECT_TRUE(im2.empty());
+    EXPECT_EQ(im2.capacity(), 0u);
+
+    sg14::interleaved_flat_map<std::string, int, std::less<>, 4> sm(sg14::sorted_unique, {{"a", 1}, {"b", 2}, {"c", 3}, {"d", 4}, {"e", 5}});
+    EXPECT_EQ(sm.find("c")->second, 3);
+    EXPECT_EQ(sm.count("z"), 0u);
+    sm.emplace("f", 6);
+    EXPECT_EQ(sm.erase("a"), 1u);
+    EXPECT_EQ(sm.begin()->first, "b");
+    EXPECT_EQ(sm.size(), 5u);
+    auto copy = sm;
+    EXPECT_EQ(copy, sm);
+    copy.clear();
+    EXPECT_TRUE(copy.empty());
+}
+
+namespace {
+struct ThrowingAssign {
+    static int countdown;
+    ThrowingAssign() = default;
+    ThrowingAssign(int v) : value(v) {}
+    ThrowingAssign(ThrowingAssign&&) = default;
+    ThrowingAssign& operator=(ThrowingAssign&& rhs) {
+        if (--countdown == 0) {
+            throw std::runtime_error("oops");
+        }
+        value = rhs.value;
+        return *this;
+    }
+    int value = 0;
+};
+int ThrowingAssign::countdown = 0;
+} // namespace
+
+TEST(flat_map, InterleavedExceptionSafety)
+{
+    // If shifting the elements throws, the map is cleared rather than left out of order.
+    sg14::interleaved_flat_map<int, ThrowingAssign, std::less<int>, 4> im;
+    ThrowingAssign::countdown = 1000;
+    for (int i = 0; i < 10; ++i) {
+        im.try_emplace(2 * i, i);
+    }
+    ThrowingAssign::countdown = 3;
+    EXPECT_THROW(im.try_emplace(1, 42), std::runtime_error);
+    EXPECT_TRUE(im.empty());
+    EXPECT_EQ(im.capacity(), 0u);
+
+    ThrowingAssign::countdown = 1000;
+    for (int i = 0; i < 10; ++i) {
+        im.try_emplace(2 * i, i);
+    }
+    ThrowingAssign::countdown = 3;
+    EXPECT_THROW(im.erase(im.begin(), im.begin() + 2), std::runtime_error);
+    EXPECT_TRUE(im.empty());
+    ThrowingAssign::countdown = 1000;
+    im.try_emplace(5, 5);
+    EXPECT_EQ(im.at(5).value, 5);
+}
+
+namespace {
+struct CountedString {
+    static int constructions;
+    CountedString() = default;
+    explicit CountedString(const char *p) : s(p) { ++constructions; }
+    friend bool operator<(const CountedString& a, const CountedString& b) { return a.s < b.s; }
+    friend bool operator<(const CountedString& a, const char *b) { return a.s < b; }
+    friend bool operator<(const char *a, const CountedString& b) { return a < b.s; }
+    std::string s;
+};
+int CountedString::constructions = 0;
+
+template<class F>
+struct TransparentRef {
+    F *f;
+    using is_transparent = void;
+    template<class A, class B> bool operator()(const A& a, const B& b) const { return (*f)(a, b); }
+};
+} // namespace
+
+TEST(flat_map, HeterogeneousInsertion)
+{
+    sg14::flat_map<CountedString, int, std::less<>> fm;
+    CountedString::constructions = 0;
+    EXPECT_TRUE(fm.try_emplace("b", 2).second);
+    EXPECT_FALSE(fm.try_emplace("b", 20).second);
+    EXPECT_EQ(CountedString::constructions, 1);
+    fm["b"] += 1;
+    fm["a"] = 1;
+    EXPECT_EQ(CountedString::constructions, 2);
+    EXPECT_TRUE(fm.insert_or_assign("c", 4).second);
+    EXPECT_FALSE(fm.insert_or_assign("c", 5).second);
+    EXPECT_EQ(fm.try_emplace(fm.begin(), "d", 6)->second, 6);
+    EXPECT_EQ(fm.insert_or_assign(fm.end(), "d", 7)->second, 7);
+    EXPECT_EQ(CountedString::constructions, 4);
+    EXPECT_EQ(fm.size(), 4u);
+    EXPECT_EQ(fm.find("a")->second, 1);
+    EXPECT_EQ(fm.find("b")->second, 3);
+    EXPECT_EQ(fm.find("c")->second, 5);
+    EXPECT_EQ(fm.find("d")->second, 7);
+
+    sg14::interleaved_flat_map<CountedString, int, std::less<>> im;
+    CountedString::constructions = 0;
+    im["x"] = 1;
+    im["x"] += 1;
+    EXPECT_FALSE(im.try_emplace("x", 3).second);
+    EXPECT_FALSE(im.insert_or_assign("x", 4).second);
+    EXPECT_EQ(CountedString::constructions, 1);
+    EXPECT_EQ(im.find("x")->second, 4);
+
+    // Keys of the exact key type still work, including non-const lvalues.
+    sg14::flat_map<int, int, std::less<>> fi;
+    int k = 42;
+    fi[k] = 1;
+    fi.try_emplace(k, 2);
+    fi.insert_or_assign(k, 3);
+    EXPECT_EQ(fi.at(42), 3);
+
+    // The hinted overloads use the hint as emplace_hint does: a correct one costs
+    // at most two comparisons, and an incorrect one still does the right thing.
+    int comparisons = 0;
+    auto counting_less = [&](const auto& a, const auto& b) { ++comparisons; return a < b; };
+    sg14::flat_map<long, int, TransparentRef<decltype(counting_less)>> fh({&counting_less});
+    for (int i = 0; i < 100; i += 2) {
+        fh.try_emplace(fh.end(), i, i);
+    }
+    comparisons = 0;
+    auto it = fh.try_emplace(fh.begin() + 25, 49, 1);
+    EXPECT_LE(comparisons, 2);
+    EXPECT_EQ(it, fh.begin() + 25);
+    comparisons = 0;
+    it = fh.try_emplace(fh.end(), short(100), 2);
+    EXPECT_LE(comparisons, 2);
+    EXPECT_EQ(it, fh.end() - 1);
+    comparisons = 0;
+    it = fh.insert_or_assign(fh.begin(), -1, 3);
+    EXPECT_LE(comparisons, 2);
+    EXPECT_EQ(it, fh.begin());
+    comparisons = 0;
+    it = fh.insert_or_assign(fh.begin() + 2, short(1), 4);
+    EXPECT_LE(comparisons, 2);
+    EXPECT_EQ(it, fh.begin() + 2);
+    EXPECT_EQ(fh.insert_or_assign(fh.end(), short(4), 5)->second, 5);
+    EXPECT_EQ(fh.try_emplace(fh.begin(), short(98), 6)->second, 98);
+    EXPECT_EQ(fh.try_emplace(fh.end(), 3L, 7)->first, 3);
+    EXPECT_EQ(fh.size(), 55u);
+    EXPECT_TRUE(std::is_sorted(fh.keys().begin(), fh.keys().end()));
+}
+
 TEST(flat_map, VectorBool)
 {
     using FM = sg14::flat_map<bool, bool>;
@@ -9,6 +9,7 @@
 #if __has_include(<memory_resource>)
 #include <memory_resource>
 #endif
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -141,6 +142,182 @@ TEST(flat_set, ThrowingSwapDoesntBreakInvariants)
     // set to `true`, then flat_set's behavior would be undefined.
 }
 
+namespace {
+
+template<class FS>
+void check_arithmetic_lower_bound(typename FS::key_type lo, typename FS::key_type step)
+{
+    using Key = typename FS::key_type;
+    for (int n = 0; n < 100; ++n) {
+        FS fs;
+        for (int i = 0; i < n; ++i) {
+            fs.insert(Key(lo + step * Key(2 * i)));
+        }
+        const FS& cfs = fs;
+        for (int i = -1; i <= 2 * n; ++i) {
+            Key k = Key(lo + step * Key(i));
+            auto expected = std::lower_bound(fs.begin(), fs.end(), k) - fs.begin();
+            EXPECT_EQ(fs.lower_bound(k) - fs.begin(), expected);
+            EXPECT_EQ(cfs.lower_bound(k) - cfs.begin(), expected);
+            EXPECT_EQ(fs.equal_range(k).first - fs.begin(), expected);
+            EXPECT_EQ(cfs.equal_range(k).second - cfs.begin(), expected + (i >= 0 && i % 2 == 0 && i < 2 * n));
+            EXPECT_EQ(fs.contains(k), (i >= 0 && i % 2 == 0 && i < 2 * n));
+        }
+    }
+}
+
+} // namespace
+
+TEST(flat_set, ArithmeticLowerBound)
+{
+    check_arithmetic_lower_bound<sg14::flat_set<int>>(-50, 1);
+    check_arithmetic_lower_bound<sg14::flat_set<int, std::less<>>>(-50, 1);
+    check_arithmetic_lower_bound<sg14::flat_set<unsigned>>(0x7FFFFFC0u, 1);
+    check_arithmetic_lower_bound<sg14::flat_set<unsigned char>>(0, 1);
+    check_arithmetic_lower_bound<sg14::flat_set<long long>>(-(1LL << 40), 1LL << 33);
+    check_arithmetic_lower_bound<sg14::flat_set<float>>(-2.5f, 0.25f);
+    check_arithmetic_lower_bound<sg14::flat_set<double, std::less<double>, std::deque<double>>>(-2.5, 0.25);
+}
+
+TEST(flat_set, FindMany)
+{
+    sg14::flat_set<int> fs;
+    std::vector<int> queries = {5, 3, 9, -1, 0, 5};
+    std::vector<sg14::flat_set<int>::iterator> its(queries.size());
+    EXPECT_EQ(fs.find_many(queries.begin(), queries.end(), its.begin()), its.end());
+    for (auto it : its) {
+        EXPECT_EQ(it, fs.end());
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        fs.insert(i);
+    }
+    queries.clear();
+    for (int i = 0; i < 500; ++i) {
+        queries.push_back((i * 7919) % 1010 - 5);
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+        const sg14::flat_set<int>& cfs = fs;
+        std::vector<sg14::flat_set<int>::const_iterator> cits;
+        cfs.find_many(queries.begin(), queries.end(), std::back_inserter(cits));
+        std::vector<bool> found;
+        cfs.contains_many(queries.begin(), queries.end(), std::back_inserter(found));
+        ASSERT_EQ(cits.size(), queries.size());
+        ASSERT_EQ(found.size(), queries.size());
+        for (size_t i = 0; i < queries.size(); ++i) {
+            EXPECT_EQ(cits[i], cfs.find(queries[i]));
+            EXPECT_EQ(found[i], cfs.contains(queries[i]));
+        }
+        std::sort(queries.begin(), queries.end());
+    }
+
+    sg14::flat_set<bool> fs2 = {true};
+    bool bools[] = {false, true};
+    bool contained[2] = {};
+    fs2.contains_many(bools, bools + 2, contained);
+    EXPECT_FALSE(contained[0]);
+    EXPECT_TRUE(contained[1]);
+}
+
+TEST(flat_set, SortedRuns)
+{
+    int comparisons = 0;
+    auto counting_less = [&](int a, int b) { ++comparisons; return a < b; };
+    using FS = sg14::flat_set<int, decltype(counting_less)>;
+
+    // Already-sorted input should be validated and deduplicated in linear time.
+    std::vector<int> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(i / 2);
+    }
+    FS fs(counting_less);
+    fs.replace(keys);
+    EXPECT_EQ(fs.size(), 500u);
+    EXPECT_LE(comparisons, 2010);
+
+    // So should reverse-sorted input.
+    std::reverse(keys.begin(), keys.end());
+    comparisons = 0;
+    fs.replace(keys);
+    EXPECT_EQ(fs.size(), 500u);
+    EXPECT_LE(comparisons, 2010);
+
+    auto check = [](const std::vector<int>& ks, int expected_size) {
+        sg14::flat_set<int> s(ks);
+        EXPECT_EQ(s.size(), size_t(expected_size));
+        EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+        EXPECT_TRUE(std::includes(s.begin(), s.end(), ks.begin(), ks.end()) || !std::is_sorted(ks.begin(), ks.end()));
+    };
+    // Several sorted runs appended together.
+    keys.clear();
+    for (int run = 0; run < 5; ++run) {
+        for (int i = 0; i < 300; ++i) {
+            keys.push_back(i * 5 + run);
+        }
+    }
+    check(keys, 1500);
+    // Mostly sorted, with a few elements out of place.
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i + 7 < keys.size(); i += 97) {
+        std::swap(keys[i], keys[i + 7]);
+    }
+    check(keys, 1500);
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i < 30; ++i) {
+        std::swap(keys[(i * 7919) % keys.size()], keys[(i * 104729) % keys.size()]);
+    }
+    std::swap(keys[100], keys[1000]);
+    std::swap(keys[101], keys[1001]);
+    check(keys, 1500);
+    // Short runs and pseudo-random input.
+    keys.clear();
+    for (int i = 0; i < 2000; ++i) {
+        keys.push_back((i * 7919) % 1009);
+    }
+    check(keys, 1009);
+    check({3, 2, 1, 1, 2, 3, 3, 2, 1}, 3);
+    check({}, 0);
+    check({42}, 1);
+}
+
+TEST(flat_set, SortThreads)
+{
+    std::vector<int> keys;
+    for (int i = 0; i < 100000; ++i) {
+        keys.push_back((i * 7919) % 65521);
+    }
+    for (size_t threads : {0, 1, 3, 8}) {
+        sg14::flat_set<int> fs;
+        fs.replace(sg14::sort_threads(threads), keys);
+        EXPECT_EQ(fs.size(), 65521u);
+        EXPECT_TRUE(std::is_sorted(fs.begin(), fs.end()));
+        EXPECT_EQ(*fs.begin(), 0);
+        EXPECT_EQ(*fs.rbegin(), 65520);
+    }
+    sg14::flat_set<int, std::greater<int>> fs2(sg14::sort_threads(4), keys.begin(), keys.end());
+    EXPECT_EQ(fs2.size(), 65521u);
+    EXPECT_TRUE(std::is_sorted(fs2.begin(), fs2.end(), std::greater<int>()));
+}
+
+TEST(flat_set, SortThreadsThrows)
+{
+    // An exception thrown on a worker thread reaches the caller,
+    // and the flat_set is left empty.
+    auto less = [](int a, int b) {
+        if (a == 12345 || b == 12345) {
+            throw std::runtime_error("oops");
+        }
+        return a < b;
+    };
+    std::vector<int> keys;
+    for (int i = 0; i < 100000; ++i) {
+        keys.push_back((i * 7919) % 65521);
+    }
+    sg14::flat_set<int, decltype(less)> fs(less);
+    fs.insert(1);
+    ASSERT_THROW(fs.replace(sg14::sort_threads(4), keys), std::runtime_error);
+    EXPECT_TRUE(fs.empty());
+}
+
 TEST(flat_set, VectorBool)
 {
 #if __cplusplus >= 201402L  // C++11 doesn't support vector<bool>::emplace
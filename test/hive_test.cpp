@@ -8,18 +8,22 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <atomic>
 #if __has_include(<concepts>)
 #include <concepts>
 #endif
 #include <functional>
 #include <iterator>
+#include <map>
 #include <memory>
 #if __has_include(<memory_resource>)
 #include <memory_resource>
 #endif
 #include <numeric>
 #include <random>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -695,6 +699,171 @@ TYPED_TEST(hivet, CustomDistanceFunctionRev)
 #endif
 }
 
+TYPED_TEST(hivet, Segments)
+{
+    using Hive = TypeParam;
+    using T = typename Hive::value_type;
+    Hive h;
+    EXPECT_EQ(h.segments().begin(), h.segments().end());
+    for (int i = 0; i < 2000; ++i) {
+        h.insert(hivet_setup<Hive>::value(i));
+    }
+    std::mt19937 g;
+    for (auto it = h.begin(); it != h.end(); ) {
+        it = (g() % 3 == 0) ? h.erase(it) : std::next(it);
+    }
+    h.erase(h.begin());
+    h.erase(std::next(h.begin(), 100), std::next(h.begin(), 150));
+    EXPECT_INVARIANTS(h);
+
+    size_t total = 0;
+    std::vector<const T*> visited;
+    for (const auto& seg : h.segments()) {
+        size_t live = 0;
+        seg.for_each_run([&](size_t first, size_t last) {
+            EXPECT_LT(first, last);
+            EXPECT_LE(last, seg.extent());
+            EXPECT_TRUE(last == seg.extent() || seg.skipfield()[last] != 0);
+            for (size_t i = first; i != last; ++i) {
+                EXPECT_EQ(seg.skipfield()[i], 0);
+                ++live;
+                visited.push_back(&seg[i]);
+            }
+        });
+        EXPECT_EQ(live, seg.size());
+        if (seg.is_packed()) {
+            EXPECT_EQ(seg.size(), seg.extent());
+        }
+        total += seg.size();
+    }
+    EXPECT_EQ(total, h.size());
+
+    std::vector<const T*> expected;
+    for (const T& t : h) {
+        expected.push_back(&t);
+    }
+    EXPECT_EQ(visited, expected);
+
+    visited.clear();
+    sg14::hive_for_each(h, [&](T& t) { visited.push_back(&t); });
+    EXPECT_EQ(visited, expected);
+
+    const Hive& ch = h;
+    visited.clear();
+    auto f = sg14::hive_for_each(ch, [&, n = 0](const T& t) mutable { visited.push_back(&t); return ++n; });
+    EXPECT_EQ(visited, expected);
+    EXPECT_EQ(f(T()), static_cast<int>(h.size()) + 1);
+
+    h.clear();
+    size_t segments = 0;
+    sg14::hive_for_each(h, [&](T&) { ++segments; });
+    EXPECT_EQ(segments, 0u);
+}
+
+TYPED_TEST(hivet, ParallelForEach)
+{
+    using Hive = TypeParam;
+    using T = typename Hive::value_type;
+    Hive h;
+    for (int i = 0; i < 5000; ++i) {
+        h.insert(hivet_setup<Hive>::value(i % 100));
+    }
+    std::mt19937 g;
+    for (auto it = h.begin(); it != h.end(); ) {
+        it = (g() % 4 == 0) ? h.erase(it) : std::next(it);
+    }
+    for (size_t threads : {0, 1, 2, 3, 16}) {
+        std::vector<std::atomic<int>> counts(100);
+        sg14::hive_parallel_for_each(h, [&](const T& t) {
+            for (int i = 0; i < 100; ++i) {
+                if (hivet_setup<Hive>::int_eq_t(i, t)) {
+                    ++counts[i];
+                }
+            }
+        }, threads);
+        std::vector<int> expected(100);
+        for (const T& t : h) {
+            for (int i = 0; i < 100; ++i) {
+                expected[i] += hivet_setup<Hive>::int_eq_t(i, t);
+            }
+        }
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_EQ(counts[i], expected[i]);
+        }
+    }
+}
+
+TYPED_TEST(hivet, ParallelEraseIf)
+{
+    using Hive = TypeParam;
+    using T = typename Hive::value_type;
+    for (size_t threads : {0, 1, 2, 3, 16}) {
+        Hive h;
+        for (int i = 0; i < 5000; ++i) {
+            h.insert(hivet_setup<Hive>::value(i % 100));
+        }
+        std::mt19937 g;
+        for (auto it = h.begin(); it != h.end(); ) {
+            it = (g() % 4 == 0) ? h.erase(it) : std::next(it);
+        }
+        Hive expected = h;
+        auto pred = [](const T& t) {
+            for (int i : {0, 1, 2, 3, 5, 8, 13, 21, 34, 55, 89}) {
+                if (hivet_setup<Hive>::int_eq_t(i, t)) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        auto n = std::erase_if(expected, pred);
+        EXPECT_EQ(sg14::hive_parallel_erase_if(h, pred, threads), n);
+        EXPECT_INVARIANTS(h);
+        EXPECT_TRUE(std::equal(h.begin(), h.end(), expected.begin(), expected.end()));
+
+        // Erasing everything retires every group.
+        n = h.size();
+        EXPECT_EQ(sg14::hive_parallel_erase_if(h, [](const T&) { return true; }, threads), n);
+        EXPECT_TRUE(h.empty());
+        EXPECT_INVARIANTS(h);
+        EXPECT_EQ(sg14::hive_parallel_erase_if(h, [](const T&) { return true; }, threads), 0u);
+    }
+}
+
+TEST(hive, ParallelEraseIfThrows)
+{
+    sg14::hive<int> h;
+    for (int i = 0; i < 5000; ++i) {
+        h.insert(i);
+    }
+    auto copy = h;
+    EXPECT_THROW(sg14::hive_parallel_erase_if(h, [](int i) {
+        if (i == 4000) {
+            throw std::runtime_error("oops");
+        }
+        return i % 2 == 0;
+    }, 4), std::runtime_error);
+    EXPECT_TRUE(std::equal(h.begin(), h.end(), copy.begin(), copy.end()));
+    EXPECT_INVARIANTS(h);
+}
+
+TEST(hive, SegmentsArePackedAfterInsert)
+{
+    sg14::hive<int> h;
+    for (int i = 0; i < 1000; ++i) {
+        h.insert(i);
+    }
+    int expected = 0;
+    for (auto seg : h.segments()) {
+        EXPECT_TRUE(seg.is_packed());
+        static_assert(decltype(seg)::is_contiguous, "");
+        const int *p = seg.data();
+        for (size_t i = 0; i < seg.size(); ++i) {
+            EXPECT_EQ(p[i], expected++);
+        }
+    }
+    EXPECT_EQ(expected, 1000);
+}
+
 TYPED_TEST(hivet, CopyConstructor)
 {
     using Hive = TypeParam;
@@ -1656,6 +1825,129 @@ TYPED_TEST(hivet, EraseInsertRandomly)
     }
 }
 
+TYPED_TEST(hivet, GetIterator)
+{
+    using Hive = TypeParam;
+    using T = typename Hive::value_type;
+
+    std::mt19937 g;
+    Hive h;
+    for (int i = 0; i < 3000; ++i) {
+        h.insert(hivet_setup<Hive>::value(i % 100));
+    }
+    h.erase(std::next(h.begin(), 100), std::next(h.begin(), 900));
+    Hive other;
+    other.insert(500, hivet_setup<Hive>::value(7));
+    h.splice(other);
+    h.reserve(h.capacity() + 200);
+    EXPECT_INVARIANTS(h);
+
+    const Hive& ch = h;
+    for (auto it = h.begin(); it != h.end(); ++it) {
+        EXPECT_EQ(h.get_iterator(std::addressof(*it)), it);
+        EXPECT_EQ(ch.get_iterator(std::addressof(*it)), typename Hive::const_iterator(it));
+    }
+
+    // get_iterator doesn't modify the hive, so lookups may run concurrently.
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (auto it = ch.begin(); it != ch.end(); ++it) {
+                if (ch.get_iterator(std::addressof(*it)) != it) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    EXPECT_EQ(mismatches, 0);
+
+    // Erase through raw pointers, in random order, until the hive is empty.
+    std::vector<const T*> ptrs;
+    for (const T& t : h) {
+        ptrs.push_back(std::addressof(t));
+    }
+    std::shuffle(ptrs.begin(), ptrs.end(), g);
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+        auto it = h.get_iterator(ptrs[i]);
+        EXPECT_EQ(std::addressof(*it), ptrs[i]);
+        h.erase(it);
+        if (i % 500 == 0) {
+            auto jt = h.insert(hivet_setup<Hive>::value(1));
+            EXPECT_EQ(h.get_iterator(std::addressof(*jt)), jt);
+            ptrs.push_back(std::addressof(*jt));
+            EXPECT_INVARIANTS(h);
+        }
+    }
+    EXPECT_TRUE(h.empty());
+
+    Hive moved = std::move(h);
+    moved.insert(hivet_setup<Hive>::value(1));
+    EXPECT_EQ(moved.get_iterator(std::addressof(*moved.begin())), moved.begin());
+    moved.shrink_to_fit();
+    EXPECT_EQ(moved.get_iterator(std::addressof(*moved.begin())), moved.begin());
+}
+
+TYPED_TEST(hivet, Compact)
+{
+    using Hive = TypeParam;
+    using T = typename Hive::value_type;
+
+    std::mt19937 g;
+    Hive h;
+    for (int i = 0; i < 5000; ++i) {
+        h.insert(hivet_setup<Hive>::value(i % 100));
+    }
+    for (auto it = h.begin(); it != h.end(); ) {
+        it = (g() % 10 < 7) ? h.erase(it) : std::next(it);
+    }
+    h.erase(std::next(h.begin(), 10), std::next(h.begin(), 60));
+    EXPECT_INVARIANTS(h);
+
+    std::map<const T*, int> where;
+    for (const T& t : h) {
+        for (int v = 0; v < 100; ++v) {
+            if (hivet_setup<Hive>::int_eq_t(v, t)) {
+                where[std::addressof(t)] = v;
+                break;
+            }
+        }
+    }
+    ASSERT_EQ(where.size(), h.size());
+    auto segments_before = std::distance(h.segments().begin(), h.segments().end());
+    auto capacity_before = h.capacity();
+
+    size_t calls = 0;
+    auto moved = h.compact([&](T *from, T *to) {
+        auto node = where.extract(from);
+        ASSERT_FALSE(node.empty());
+        EXPECT_TRUE(hivet_setup<Hive>::int_eq_t(node.mapped(), *to));
+        node.key() = to;
+        EXPECT_TRUE(where.insert(std::move(node)).inserted);
+        ++calls;
+    });
+    EXPECT_EQ(moved, calls);
+    EXPECT_GT(moved, 0u);
+    EXPECT_INVARIANTS(h);
+    EXPECT_LT(std::distance(h.segments().begin(), h.segments().end()), segments_before);
+    EXPECT_LT(h.capacity(), capacity_before);
+    ASSERT_EQ(where.size(), h.size());
+    for (const T& t : h) {
+        auto it = where.find(std::addressof(t));
+        ASSERT_NE(it, where.end());
+        EXPECT_TRUE(hivet_setup<Hive>::int_eq_t(it->second, t));
+    }
+
+    h.insert(200, hivet_setup<Hive>::value(1));
+    EXPECT_INVARIANTS(h);
+    h.clear();
+    EXPECT_EQ(h.compact([](T*, T*) {}), 0u);
+    EXPECT_INVARIANTS(h);
+}
+
 TYPED_TEST(hivet, EraseEmptyRange)
 {
     using Hive = TypeParam;
@@ -1811,6 +2103,87 @@ TYPED_TEST(hivet, SortAndUnique)
     }
 }
 
+TYPED_TEST(hivet, SortInPlace)
+{
+    using Hive = TypeParam;
+    using Value = typename Hive::value_type;
+
+    std::mt19937 g;
+    for (int n : {1, 2, 3, 10, 100, 500, 50'000}) {
+        std::vector<Value> v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(hivet_setup<Hive>::value(g() % 1000));
+        }
+        // Small groups, with holes, so that most merges are too long for the buffer.
+        Hive h = make_rope<Hive>(10, n + 100);
+        h.insert(v.begin(), v.end());
+        for (auto it = h.begin(); it != h.end(); ) {
+            it = (g() % 4 == 0) ? h.erase(it) : std::next(it);
+        }
+        v.assign(h.begin(), h.end());
+        std::vector<const Value*> addresses;
+        for (const Value& t : h) {
+            addresses.push_back(std::addressof(t));
+        }
+
+        h.sort_in_place();
+        std::sort(v.begin(), v.end());
+        EXPECT_TRUE(std::equal(h.begin(), h.end(), v.begin(), v.end()));
+        EXPECT_INVARIANTS(h);
+        std::vector<const Value*> after;
+        for (const Value& t : h) {
+            after.push_back(std::addressof(t));
+        }
+        EXPECT_EQ(addresses, after);
+
+        h.sort_in_place(std::greater<Value>());
+        std::reverse(v.begin(), v.end());
+        EXPECT_TRUE(std::equal(h.begin(), h.end(), v.begin(), v.end()));
+        EXPECT_INVARIANTS(h);
+    }
+}
+
+TEST(hive, RadixSort)
+{
+    struct Entity {
+        unsigned long long key_;
+        int payload_;
+    };
+    auto key = [](const Entity& e) { return e.key_; };
+    std::mt19937_64 g;
+    for (int n : {1, 2, 3, 10, 100, 500, 50'000}) {
+        for (int bits : {8, 20, 64}) {
+            std::vector<Entity> v;
+            for (int i = 0; i < n; ++i) {
+                unsigned long long k = (bits == 64) ? g() : g() % (1ull << bits);
+                v.push_back(Entity{k, i});
+            }
+            sg14::hive<Entity> h = make_rope<sg14::hive<Entity>>(100, n);
+            h.insert(v.begin(), v.end());
+            h.erase(h.begin());
+            v.erase(v.begin());
+            h.radix_sort(key);
+            EXPECT_INVARIANTS(h);
+            EXPECT_TRUE(std::is_sorted(h.begin(), h.end(), [](const Entity& a, const Entity& b) { return a.key_ < b.key_; }));
+            std::vector<int> expected;
+            std::vector<int> actual;
+            for (const Entity& e : v) {
+                expected.push_back(e.payload_);
+            }
+            for (const Entity& e : h) {
+                actual.push_back(e.payload_);
+            }
+            std::sort(expected.begin(), expected.end());
+            std::sort(actual.begin(), actual.end());
+            EXPECT_EQ(actual, expected);
+        }
+    }
+
+    sg14::hive<unsigned char> h = {5, 3, 200, 1, 3};
+    h.radix_sort([](unsigned char c) { return static_cast<unsigned char>(255 - c); });
+    EXPECT_TRUE(std::equal(h.begin(), h.end(), std::vector<unsigned char>{200, 5, 3, 3, 1}.begin()));
+}
+
 TYPED_TEST(hivet, ConstructFromInitializerList)
 {
     using Hive = TypeParam;
@@ -2624,6 +2997,94 @@ TEST(hive, StdEraseIf)
     EXPECT_TRUE(std::all_of(h.begin(), h.end(), [](int i){ return i < 500; }));
 }
 
+TYPED_TEST(hivet, StdEraseIfRebuildsFreeLists)
+{
+    using Hive = TypeParam;
+    using T = typename Hive::value_type;
+    std::mt19937 g;
+    Hive h;
+    std::vector<int> model;
+    for (int i = 0; i < 3000; ++i) {
+        h.insert(hivet_setup<Hive>::value(i % 100));
+        model.push_back(i % 100);
+    }
+    h.erase(std::next(h.begin(), 10), std::next(h.begin(), 700));
+    model.erase(model.begin() + 10, model.begin() + 700);
+    for (unsigned round = 0; round < 6; ++round) {
+        std::vector<char> doomed;
+        for (size_t i = 0; i < model.size(); ++i) {
+            doomed.push_back(g() % 10 < round * 2);
+        }
+        // The predicate is called exactly once per element, in iteration order.
+        size_t k = 0;
+        auto n = std::erase_if(h, [&](const T& t) {
+            EXPECT_TRUE(hivet_setup<Hive>::int_eq_t(model[k], t));
+            return doomed[k++] != 0;
+        });
+        EXPECT_EQ(k, model.size());
+        std::vector<int> kept;
+        for (size_t i = 0; i < model.size(); ++i) {
+            if (!doomed[i]) {
+                kept.push_back(model[i]);
+            }
+        }
+        EXPECT_EQ(n, model.size() - kept.size());
+        model = kept;
+        EXPECT_INVARIANTS(h);
+        ASSERT_EQ(h.size(), model.size());
+        EXPECT_TRUE(std::equal(model.begin(), model.end(), h.begin(), h.end(), hivet_setup<Hive>::int_eq_t));
+
+        // Refill some of the holes, then erase a few single elements and a range.
+        for (int i = 0; i < 200; ++i) {
+            h.insert(hivet_setup<Hive>::value(i % 100));
+        }
+        if (h.size() > 20) {
+            h.erase(std::next(h.begin(), 3));
+            h.erase(std::next(h.begin(), 5), std::next(h.begin(), 15));
+        }
+        model.assign(h.size(), 0);
+        size_t i = 0;
+        for (const T& t : h) {
+            for (int v = 0; v < 100; ++v) {
+                if (hivet_setup<Hive>::int_eq_t(v, t)) {
+                    model[i] = v;
+                    break;
+                }
+            }
+            ++i;
+        }
+        EXPECT_INVARIANTS(h);
+    }
+    EXPECT_EQ(std::erase_if(h, [](const T&) { return true; }), model.size());
+    EXPECT_TRUE(h.empty());
+    EXPECT_INVARIANTS(h);
+    h.insert(hivet_setup<Hive>::value(1));
+    EXPECT_EQ(h.size(), 1u);
+    EXPECT_INVARIANTS(h);
+}
+
+TEST(hive, StdEraseIfThrows)
+{
+    sg14::hive<int> h;
+    for (int i = 0; i < 1000; ++i) {
+        h.insert(i);
+    }
+    EXPECT_THROW(std::erase_if(h, [](int i) {
+        if (i == 600) {
+            throw std::runtime_error("oops");
+        }
+        return i % 2 == 0;
+    }), std::runtime_error);
+    EXPECT_EQ(h.size(), 700u);
+    EXPECT_INVARIANTS(h);
+    int expected = 1;
+    for (int i : h) {
+        EXPECT_EQ(i, expected);
+        expected += (expected < 599) ? 2 : 1;
+    }
+    EXPECT_EQ(expected, 1000);
+}
+
 #if __cplusplus >= 202002L
 TEST(hive, ConstexprCtor)
 {
@@ -2806,6 +3267,90 @@ TEST(hive, PmrCorrectAllocAwareCtors)
     }
     EXPECT_INVARIANTS(h1);
 }
+
+struct CountingResource : std::pmr::memory_resource {
+    std::atomic<int> allocations_{0};
+    std::atomic<int> deallocations_{0};
+    void *do_allocate(size_t n, size_t align) override {
+        ++allocations_;
+        return std::pmr::new_delete_resource()->allocate(n, align);
+    }
+    void do_deallocate(void *p, size_t n, size_t align) override {
+        ++deallocations_;
+        std::pmr::new_delete_resource()->deallocate(p, n, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& rhs) const noexcept override { return this == &rhs; }
+};
+
+TEST(hive, GroupPool)
+{
+    using Hive = sg14::hive<int, std::pmr::polymorphic_allocator<int>>;
+    CountingResource mr;
+    sg14::hive_group_pool<int, std::pmr::polymorphic_allocator<int>> pool(&mr);
+    {
+        Hive h(pool);
+        EXPECT_EQ(h.group_pool(), &pool);
+        for (int i = 0; i < 1000; ++i) {
+            h.insert(i);
+        }
+        EXPECT_INVARIANTS(h);
+    }
+    // Only the hive's own bookkeeping went back to mr; its groups went to the pool.
+    EXPECT_GT(pool.size(), 0u);
+    EXPECT_EQ(mr.allocations_ - mr.deallocations_, static_cast<int>(pool.size()));
+    size_t pooled = pool.capacity();
+    EXPECT_GE(pooled, 1000u);
+
+    // The same sequence of insertions asks for the same group capacities again.
+    {
+        Hive h(pool);
+        for (int i = 0; i < 1000; ++i) {
+            h.insert(i);
+        }
+        EXPECT_EQ(pool.size(), 0u);
+        EXPECT_EQ(h.capacity(), pooled);
+        EXPECT_INVARIANTS(h);
+        EXPECT_TRUE(std::equal(h.begin(), h.end(), std::vector<int>(h.begin(), h.end()).begin()));
+        h.erase(h.begin(), std::next(h.begin(), 500));
+        h.trim_capacity();
+        EXPECT_GT(pool.size(), 0u);
+
+        Hive h2 = std::move(h);
+        EXPECT_EQ(h2.group_pool(), &pool);
+        Hive h3(&mr);
+        EXPECT_EQ(h3.group_pool(), nullptr);
+        h3 = std::move(h2);
+        EXPECT_EQ(h3.group_pool(), &pool);
+    }
+    EXPECT_EQ(pool.capacity(), pooled);
+    EXPECT_EQ(mr.allocations_ - mr.deallocations_, static_cast<int>(pool.size()));
+
+    Hive other;
+    EXPECT_THROW(other.set_group_pool(&pool), std::invalid_argument);
+    EXPECT_EQ(other.group_pool(), nullptr);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int round = 0; round < 50; ++round) {
+                Hive h(pool);
+                for (int i = 0; i < 100 * t + round; ++i) {
+                    h.insert(i);
+                }
+                std::erase_if(h, [](int i) { return i % 3 == 0; });
+                h.shrink_to_fit();
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    EXPECT_EQ(mr.allocations_ - mr.deallocations_, static_cast<int>(pool.size()));
+    pool.release();
+    EXPECT_EQ(pool.size(), 0u);
+    EXPECT_EQ(pool.capacity(), 0u);
+    EXPECT_EQ(mr.allocations_, mr.deallocations_);
+}
 #endif // __cpp_lib_memory_resource
 
 TEST(hive, RangeInsertRegressionTest)
@@ -0,0 +1,158 @@
+#if __cplusplus >= 201703L
+
+#include <sg14/slot_map_soa.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Position { float x, y; };
+struct Velocity { float dx, dy; };
+
+struct ThrowsOnValue {
+    explicit ThrowsOnValue(int v) : value(v) { if (v < 0) throw std::runtime_error("negative"); }
+    int value;
+};
+
+} // namespace
+
+TEST(slot_map_soa, Basic)
+{
+    using SM = sg14::slot_map_soa<std::pair<unsigned, unsigned>, Position, Velocity, std::string>;
+    static_assert(SM::column_count == 3);
+    static_assert(std::is_same_v<SM::column_type<1>, Velocity>);
+    SM sm;
+    EXPECT_TRUE(sm.empty());
+    auto k1 = sm.emplace(Position{1, 2}, Velocity{3, 4}, "one");
+    auto k2 = sm.insert(Position{5, 6}, Velocity{7, 8}, std::string("two"));
+    auto k3 = sm.emplace(Position{9, 10}, Velocity{11, 12}, std::string(3, 'x'));
+    EXPECT_EQ(sm.size(), 3u);
+    EXPECT_EQ(sm.at<Position>(k1).x, 1);
+    EXPECT_EQ(sm.at<1>(k2).dy, 8);
+    EXPECT_EQ(sm.at<std::string>(k3), "xxx");
+
+    auto pos = sm.column<Position>();
+    EXPECT_EQ(pos.size(), 3u);
+    EXPECT_EQ(pos.data() + 1, &sm.at<Position>(k2));
+    for (auto& p : sm.column<0>()) {
+        p.x += 100;
+    }
+    EXPECT_EQ(sm.find<Position>(k3)->x, 109);
+
+    // Erasing moves the last value into the hole, in every column.
+    EXPECT_EQ(sm.erase(k1), 1u);
+    EXPECT_EQ(sm.erase(k1), 0u);
+    EXPECT_EQ(sm.size(), 2u);
+    EXPECT_FALSE(sm.contains(k1));
+    EXPECT_EQ(sm.find<2>(k1), nullptr);
+    EXPECT_THROW(sm.at<Velocity>(k1), std::out_of_range);
+    EXPECT_EQ(sm.index_of(k3), 0u);
+    EXPECT_EQ(sm.key_at(0), k3);
+    EXPECT_EQ(sm.column<Position>()[0].y, 10);
+    EXPECT_EQ(sm.column<Velocity>()[0].dx, 11);
+    EXPECT_EQ(sm.column<std::string>()[0], "xxx");
+    EXPECT_EQ(sm.key_at(1), k2);
+
+    // The freed slot is reused with a new generation.
+    auto k4 = sm.emplace(Position{}, Velocity{}, "four");
+    EXPECT_EQ(k4.first, k1.first);
+    EXPECT_NE(k4.second, k1.second);
+    EXPECT_EQ(sm.slot_count(), 3u);
+
+    const SM& csm = sm;
+    EXPECT_EQ(csm.column<2>()[2], "four");
+    EXPECT_EQ(csm.at<std::string>(k4), "four");
+
+    SM sm2;
+    swap(sm, sm2);
+    EXPECT_TRUE(sm.empty());
+    EXPECT_EQ(sm2.size(), 3u);
+    sm2.clear();
+    EXPECT_TRUE(sm2.empty());
+    EXPECT_EQ(sm2.slot_count(), 0u);
+}
+
+TEST(slot_map_soa, ExceptionSafety)
+{
+    sg14::slot_map_soa<std::pair<unsigned, unsigned>, int, ThrowsOnValue> sm;
+    auto k = sm.emplace(1, 1);
+    EXPECT_THROW(sm.emplace(2, -1), std::runtime_error);
+    EXPECT_EQ(sm.size(), 1u);
+    EXPECT_EQ(sm.column<0>().size(), 1u);
+    EXPECT_EQ(sm.column<1>().size(), 1u);
+    auto k2 = sm.emplace(3, 3);
+    EXPECT_EQ(sm.at<0>(k), 1);
+    EXPECT_EQ(sm.at<1>(k2).value, 3);
+
+    // The slot made for a failed emplace stays on the free list.
+    EXPECT_THROW(sm.emplace(4, -1), std::runtime_error);
+    EXPECT_EQ(sm.erase(k), 1u);
+    auto k3 = sm.emplace(5, 5);
+    EXPECT_FALSE(sm.contains(k));
+    EXPECT_EQ(sm.at<0>(k3), 5);
+    EXPECT_EQ(sm.at<1>(k2).value, 3);
+    EXPECT_EQ(sm.slot_count(), 3u);
+}
+
+TEST(slot_map_soa, PackedKeyOverflow)
+{
+    sg14::slot_map_soa<sg14::packed_key<4, 4>, int, float> sm;
+    for (int i = 0; i < 15; ++i) {
+        sm.emplace(i, float(i));
+    }
+    EXPECT_THROW(sm.emplace(15, 15.0f), std::length_error);
+    EXPECT_EQ(sm.size(), 15u);
+    EXPECT_EQ(sm.slot_count(), 15u);
+    for (size_t i = 0; i < 15; ++i) {
+        EXPECT_EQ(sm.at<int>(sm.key_at(i)), int(i));
+    }
+    sg14::slot_map_soa<sg14::packed_key<4, 4>, int> sm2;
+    EXPECT_THROW(sm2.reserve_slots(16), std::length_error);
+}
+
+TEST(slot_map_soa, MatchesSlotMap)
+{
+    // Mirror every operation on a slot_map of tuples.
+    using Key = sg14::packed_key<20, 12>;
+    sg14::slot_map_soa<Key, int, std::unique_ptr<int>> soa;
+    sg14::slot_map<int, Key> model;
+    std::vector<Key> keys;
+    std::mt19937 g;
+    soa.reserve(100);
+    model.reserve(100);
+    for (int round = 0; round < 5000; ++round) {
+        if (keys.empty() || g() % 3 != 0) {
+            int v = int(g());
+            auto k = soa.emplace(v, std::make_unique<int>(v));
+            EXPECT_TRUE(k == model.insert(v));
+            keys.push_back(k);
+        } else {
+            size_t j = g() % keys.size();
+            EXPECT_EQ(soa.erase(keys[j]), model.erase(keys[j]));
+            keys[j] = keys.back();
+            keys.pop_back();
+        }
+    }
+    EXPECT_EQ(soa.size(), model.size());
+    EXPECT_EQ(soa.slot_count(), model.slot_count());
+    for (auto k : keys) {
+        EXPECT_EQ(soa.at<0>(k), model.at(k));
+        EXPECT_EQ(*soa.at<1>(k), model.at(k));
+    }
+    for (size_t i = 0; i < soa.size(); ++i) {
+        EXPECT_EQ(soa.index_of(soa.key_at(i)), i);
+        EXPECT_EQ(soa.column<0>()[i], *soa.column<1>()[i]);
+    }
+}
+
+#endif // __cplusplus >= 201703L
@@ -1,4 +1,5 @@
 #include <sg14/slot_map.h>
+#include <sg14/chunked_vector.h>
 
 #include <gtest/gtest.h>
 
@@ -9,9 +10,12 @@
 #include <iterator>
 #include <list>
 #include <memory>
+#include <numeric>
 #include <random>
+#include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace {
 namespace TestKey {
@@ -323,6 +327,58 @@ static void PartitionTest()
     EXPECT_TRUE(Monad<T>::value_of(*sm.find(key6)) == 6);
 }
 
+template<class SM>
+static void SortTest()
+{
+    using T = typename SM::mapped_type;
+    SM sm;
+    std::vector<typename SM::key_type> keys;
+    for (int i : {5, 3, 8, 1, 9, 2, 7, 4, 6, 0}) {
+        keys.push_back(sm.insert(Monad<T>::from_value(i)));
+    }
+    sm.erase(keys[4]);  // erase 9
+    auto stale_key = keys[4];
+
+    sm.sort([](const auto& a, const auto& b) {
+        return Monad<T>::value_of(a) < Monad<T>::value_of(b);
+    });
+    int expected = 0;
+    for (auto&& elt : sm) {
+        EXPECT_TRUE(int(Monad<T>::value_of(elt)) == expected);
+        ++expected;
+    }
+    EXPECT_TRUE(expected == 9);
+    int values[] = {5, 3, 8, 1, 9, 2, 7, 4, 6, 0};
+    for (int i = 0; i < 10; ++i) {
+        if (i != 4) {
+            EXPECT_TRUE(int(Monad<T>::value_of(*sm.find(keys[i]))) == values[i]);
+        }
+    }
+    EXPECT_TRUE(sm.find(stale_key) == sm.end());
+
+    // Reverse the order, and check that the keys follow their values.
+    std::vector<size_t> perm;
+    for (size_t i = sm.size(); i != 0; --i) {
+        perm.push_back(i - 1);
+    }
+    sm.apply_permutation(perm.begin(), perm.end());
+    expected = 8;
+    for (auto&& elt : sm) {
+        EXPECT_TRUE(int(Monad<T>::value_of(elt)) == expected);
+        --expected;
+    }
+    for (int i = 0; i < 10; ++i) {
+        if (i != 4) {
+            EXPECT_TRUE(int(Monad<T>::value_of(sm.at(keys[i]))) == values[i]);
+        }
+    }
+    // The slot map still works normally afterward.
+    auto k = sm.insert(Monad<T>::from_value(10));
+    sm.erase(keys[0]);
+    EXPECT_TRUE(int(Monad<T>::value_of(sm.at(k))) == 10);
+    EXPECT_TRUE(sm.size() == 9);
+}
+
 template<class SM>
 static void ReserveTest()
 {
@@ -346,6 +402,94 @@ static void ReserveTest()
     EXPECT_TRUE(sm.size() == 4);
 }
 
+template<class SM>
+static void ReusePolicyTest()
+{
+    using T = typename SM::mapped_type;
+    using Traits = sg14::slot_map_key_traits<typename SM::key_type>;
+    SM sm;
+    EXPECT_TRUE(sm.reuse_policy() == sg14::slot_reuse_policy::fifo);
+    auto k0 = sm.emplace(Monad<T>::from_value(0));
+    auto k1 = sm.emplace(Monad<T>::from_value(1));
+    auto k2 = sm.emplace(Monad<T>::from_value(2));
+    auto k3 = sm.emplace(Monad<T>::from_value(3));
+
+    // FIFO: the slot freed first is reused first.
+    sm.erase(k1);
+    sm.erase(k2);
+    k1 = sm.emplace(Monad<T>::from_value(1));
+    k2 = sm.emplace(Monad<T>::from_value(2));
+    EXPECT_TRUE(Traits::get_index(k1) == 1);
+    EXPECT_TRUE(Traits::get_index(k2) == 2);
+
+    // LIFO: the slot freed last is reused first.
+    sm.set_reuse_policy(sg14::slot_reuse_policy::lifo);
+    EXPECT_TRUE(sm.reuse_policy() == sg14::slot_reuse_policy::lifo);
+    sm.erase(k1);
+    sm.erase(k2);
+    k2 = sm.emplace(Monad<T>::from_value(2));
+    k1 = sm.emplace(Monad<T>::from_value(1));
+    EXPECT_TRUE(Traits::get_index(k2) == 2);
+    EXPECT_TRUE(Traits::get_index(k1) == 1);
+
+    // A batch of freed slots goes to the front of the free list.
+    sm.erase(k3);
+    typename SM::key_type batch[] = {k0, k2};
+    EXPECT_TRUE(sm.erase_keys(batch, batch + 2) == 2);
+    auto k = sm.emplace(Monad<T>::from_value(4));
+    EXPECT_TRUE(Traits::get_index(k) == 0);
+    k = sm.emplace(Monad<T>::from_value(5));
+    EXPECT_TRUE(Traits::get_index(k) == 2);
+    k = sm.emplace(Monad<T>::from_value(6));
+    EXPECT_TRUE(Traits::get_index(k) == 3);
+    EXPECT_TRUE(sm.slot_count() == 4);
+    EXPECT_TRUE(sm.size() == 4);
+    EXPECT_TRUE(Monad<T>::value_of(sm.at(k1)) == 1);
+    EXPECT_TRUE(sm.find(k0) == sm.end());
+    EXPECT_TRUE(sm.find(k3) == sm.end());
+}
+
+template<class SM>
+static void ShrinkSlotsTest()
+{
+    using T = typename SM::mapped_type;
+    using Traits = sg14::slot_map_key_traits<typename SM::key_type>;
+    SM sm;
+    EXPECT_TRUE(sm.shrink_slots() == 0);
+    std::vector<typename SM::key_type> keys;
+    for (int i = 0; i < 10; ++i) {
+        keys.push_back(sm.emplace(Monad<T>::from_value(i)));
+    }
+    for (int i = 9; i >= 4; --i) {
+        sm.erase(keys[i]);
+    }
+    sm.erase(keys[1]);
+    EXPECT_TRUE(sm.shrink_slots() == 6);
+    EXPECT_TRUE(sm.slot_count() == 4);
+    EXPECT_TRUE(sm.shrink_slots() == 0);
+
+    // The free slot that was kept is reused first; then new slots are created.
+    auto k = sm.emplace(Monad<T>::from_value(1));
+    EXPECT_TRUE(Traits::get_index(k) == 1);
+    for (int i = 4; i < 10; ++i) {
+        k = sm.emplace(Monad<T>::from_value(i));
+        EXPECT_TRUE(Traits::get_index(k) == static_cast<unsigned>(i));
+        EXPECT_TRUE(sm.find(keys[i]) == sm.end());
+        EXPECT_TRUE(Monad<T>::value_of(*sm.find(k)) == Monad<T>::value_of(Monad<T>::from_value(i)));
+    }
+    EXPECT_TRUE(sm.size() == 10);
+
+    // Slots that were never handed out are removed too.
+    sm.reserve_slots(20);
+    auto n = sm.slot_count();
+    EXPECT_TRUE(n >= 20);
+    EXPECT_TRUE(sm.shrink_slots() == n - 10);
+    EXPECT_TRUE(sm.slot_count() == 10);
+    k = sm.emplace(Monad<T>::from_value(10));
+    EXPECT_TRUE(Traits::get_index(k) == 10);
+    EXPECT_TRUE(sm.size() == 11);
+}
+
 template<class SM, class = decltype(std::declval<const SM&>().capacity())>
 static void VerifyCapacityExists(bool expected)
 {
@@ -545,6 +689,100 @@ static void IndexesAreUsedEvenlyTest()
 #endif
 }
 
+template<class SM>
+static void BatchInsertEraseTest()
+{
+    using T = typename SM::mapped_type;
+    using K = typename SM::key_type;
+    SM sm;
+    std::vector<T> values;
+    for (int i = 0; i < 100; ++i) {
+        values.push_back(Monad<T>::from_value(i));
+    }
+    std::vector<K> keys;
+    sm.insert(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()), std::back_inserter(keys));
+    EXPECT_TRUE(sm.size() == 100);
+    EXPECT_TRUE(keys.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(int(Monad<T>::value_of(*sm.find(keys[i]))) == i);
+    }
+
+    // Erase every third value, naming one of them twice.
+    std::vector<K> doomed;
+    for (int i = 0; i < 100; i += 3) {
+        doomed.push_back(keys[i]);
+    }
+    doomed.push_back(keys[0]);
+    EXPECT_TRUE(sm.erase_keys(doomed.begin(), doomed.end()) == 34);
+    EXPECT_TRUE(sm.erase_keys(doomed.begin(), doomed.end()) == 0);
+    EXPECT_TRUE(sm.size() == 66);
+    int total = 0;
+    for (auto&& elt : sm) {
+        total += Monad<T>::value_of(elt);
+    }
+    EXPECT_TRUE(total == 4950 - 1683);
+    for (int i = 0; i < 100; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_TRUE(sm.find(keys[i]) == sm.end());
+        } else {
+            EXPECT_TRUE(int(Monad<T>::value_of(*sm.find(keys[i]))) == i);
+        }
+    }
+
+    // The freed slots are reused before any new ones are made.
+    auto slot_count = sm.slot_count();
+    values.clear();
+    for (int i = 0; i < 34; ++i) {
+        values.push_back(Monad<T>::from_value(1000 + i));
+    }
+    keys.clear();
+    sm.insert(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()), std::back_inserter(keys));
+    EXPECT_TRUE(sm.slot_count() == slot_count);
+    EXPECT_TRUE(sm.size() == 100);
+    for (int i = 0; i < 34; ++i) {
+        EXPECT_TRUE(int(Monad<T>::value_of(*sm.find(keys[i]))) == 1000 + i);
+    }
+}
+
+template<class SM>
+static void FindManyTest()
+{
+    using T = typename SM::mapped_type;
+    using K = typename SM::key_type;
+    SM sm;
+    SM big;
+    std::vector<K> keys;
+    for (int i = 0; i < 50; ++i) {
+        keys.push_back(sm.insert(Monad<T>::from_value(i)));
+    }
+    for (int i = 0; i < 100; ++i) {
+        big.insert(Monad<T>::from_value(i));
+    }
+    // A stale key, and a key whose index is out of range.
+    K stale = keys[7];
+    sm.erase(stale);
+    keys.push_back(stale);
+    keys.push_back(big.insert(Monad<T>::from_value(100)));
+
+    std::vector<typename SM::iterator> its;
+    sm.find_many(keys.begin(), keys.end(), std::back_inserter(its));
+    EXPECT_TRUE(its.size() == keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_TRUE(its[i] == sm.find(keys[i]));
+    }
+    EXPECT_TRUE(its[50] == sm.end());
+    EXPECT_TRUE(its[51] == sm.end());
+
+    const SM& csm = sm;
+    std::vector<typename SM::const_iterator> cits;
+    keys.erase(keys.begin() + 7);
+    keys.resize(49);
+    csm.find_unchecked_many(keys.begin(), keys.end(), std::back_inserter(cits));
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_TRUE(cits[i] == csm.find(keys[i]));
+    }
+}
+
 TEST(slot_map, Basic)
 {
     // Test the most basic slot_map.
@@ -557,10 +795,15 @@ TEST(slot_map, Basic)
     EraseInLoopTest<slot_map_1>();
     EraseRangeTest<slot_map_1>();
     PartitionTest<slot_map_1>();
+    SortTest<slot_map_1>();
     ReserveTest<slot_map_1>();
+    ReusePolicyTest<slot_map_1>();
+    ShrinkSlotsTest<slot_map_1>();
     VerifyCapacityExists<slot_map_1>(true);
     GenerationsDontSkipTest<slot_map_1>();
     IndexesAreUsedEvenlyTest<slot_map_1>();
+    BatchInsertEraseTest<slot_map_1>();
+    FindManyTest<slot_map_1>();
 }
 
 TEST(slot_map, CustomKeyType)
@@ -574,10 +817,15 @@ TEST(slot_map, CustomKeyType)
     EraseInLoopTest<slot_map_2>();
     EraseRangeTest<slot_map_2>();
     PartitionTest<slot_map_2>();
+    SortTest<slot_map_2>();
     ReserveTest<slot_map_2>();
+    ReusePolicyTest<slot_map_2>();
+    ShrinkSlotsTest<slot_map_2>();
     VerifyCapacityExists<slot_map_2>(true);
     GenerationsDontSkipTest<slot_map_2>();
     IndexesAreUsedEvenlyTest<slot_map_2>();
+    BatchInsertEraseTest<slot_map_2>();
+    FindManyTest<slot_map_2>();
 
 #if __cplusplus >= 201703L
     // Test slot_map with a custom key type (C++17 destructuring).
@@ -589,10 +837,15 @@ TEST(slot_map, CustomKeyType)
     EraseInLoopTest<slot_map_3>();
     EraseRangeTest<slot_map_3>();
     PartitionTest<slot_map_3>();
+    SortTest<slot_map_3>();
     ReserveTest<slot_map_3>();
+    ReusePolicyTest<slot_map_3>();
+    ShrinkSlotsTest<slot_map_3>();
     VerifyCapacityExists<slot_map_3>(true);
     GenerationsDontSkipTest<slot_map_3>();
     IndexesAreUsedEvenlyTest<slot_map_3>();
+    BatchInsertEraseTest<slot_map_3>();
+    FindManyTest<slot_map_3>();
 #endif // __cplusplus >= 201703L
 }
 
@@ -607,10 +860,15 @@ TEST(slot_map, DequeContainer)
     EraseInLoopTest<slot_map_4>();
     EraseRangeTest<slot_map_4>();
     PartitionTest<slot_map_4>();
+    SortTest<slot_map_4>();
     ReserveTest<slot_map_4>();
+    ReusePolicyTest<slot_map_4>();
+    ShrinkSlotsTest<slot_map_4>();
     VerifyCapacityExists<slot_map_4>(false);
     GenerationsDontSkipTest<slot_map_4>();
     IndexesAreUsedEvenlyTest<slot_map_4>();
+    BatchInsertEraseTest<slot_map_4>();
+    FindManyTest<slot_map_4>();
 }
 
 TEST(slot_map, CustomRAContainer)
@@ -625,10 +883,15 @@ TEST(slot_map, CustomRAContainer)
     EraseInLoopTest<slot_map_5>();
     EraseRangeTest<slot_map_5>();
     PartitionTest<slot_map_5>();
+    SortTest<slot_map_5>();
     ReserveTest<slot_map_5>();
+    ReusePolicyTest<slot_map_5>();
+    ShrinkSlotsTest<slot_map_5>();
     VerifyCapacityExists<slot_map_5>(false);
     GenerationsDontSkipTest<slot_map_5>();
     IndexesAreUsedEvenlyTest<slot_map_5>();
+    BatchInsertEraseTest<slot_map_5>();
+    FindManyTest<slot_map_5>();
 }
 
 TEST(slot_map, CustomBidiContainer)
@@ -644,10 +907,45 @@ TEST(slot_map, CustomBidiContainer)
     EraseInLoopTest<slot_map_6>();
     EraseRangeTest<slot_map_6>();
     PartitionTest<slot_map_6>();
+    SortTest<slot_map_6>();
     ReserveTest<slot_map_6>();
+    ReusePolicyTest<slot_map_6>();
+    ShrinkSlotsTest<slot_map_6>();
     VerifyCapacityExists<slot_map_6>(false);
     GenerationsDontSkipTest<slot_map_6>();
     IndexesAreUsedEvenlyTest<slot_map_6>();
+    BatchInsertEraseTest<slot_map_6>();
+    FindManyTest<slot_map_6>();
+}
+
+TEST(slot_map, ChunkedContainer)
+{
+    // Test slot_map with a chunked container, whose growth never moves the existing values.
+    using slot_map_9 = sg14::slot_map<int, std::pair<unsigned, unsigned>, sg14::chunked_vector>;
+    BasicTests<slot_map_9>(415, 315);
+    BoundsCheckingTest<slot_map_9>();
+    FullContainerStressTest<slot_map_9>([]() { return 37; });
+    InsertEraseStressTest<slot_map_9>([i=7]() mutable { return ++i; });
+    EraseInLoopTest<slot_map_9>();
+    EraseRangeTest<slot_map_9>();
+    PartitionTest<slot_map_9>();
+    SortTest<slot_map_9>();
+    ReserveTest<slot_map_9>();
+    ReusePolicyTest<slot_map_9>();
+    ShrinkSlotsTest<slot_map_9>();
+    VerifyCapacityExists<slot_map_9>(true);
+    GenerationsDontSkipTest<slot_map_9>();
+    IndexesAreUsedEvenlyTest<slot_map_9>();
+    BatchInsertEraseTest<slot_map_9>();
+    FindManyTest<slot_map_9>();
+
+    slot_map_9 sm;
+    auto k = sm.insert(42);
+    int *p = &sm[k];
+    for (int i = 0; i < 100000; ++i) {
+        sm.insert(i);
+    }
+    EXPECT_TRUE(p == &sm[k]);
 }
 
 TEST(slot_map, MoveOnlyValueType)
@@ -666,10 +964,179 @@ TEST(slot_map, MoveOnlyValueType)
     EraseInLoopTest<slot_map_7>();
     EraseRangeTest<slot_map_7>();
     PartitionTest<slot_map_7>();
+    SortTest<slot_map_7>();
     ReserveTest<slot_map_7>();
+    ReusePolicyTest<slot_map_7>();
+    ShrinkSlotsTest<slot_map_7>();
     VerifyCapacityExists<slot_map_7>(false);
     GenerationsDontSkipTest<slot_map_7>();
     IndexesAreUsedEvenlyTest<slot_map_7>();
+    BatchInsertEraseTest<slot_map_7>();
+    FindManyTest<slot_map_7>();
+}
+
+TEST(slot_map, PackedKey)
+{
+    static_assert(sizeof(sg14::packed_key<32, 24, 8>) == 8, "");
+    static_assert(sizeof(sg14::packed_key<16, 12, 4>) == 4, "");
+    static_assert(sizeof(sg14::packed_key<10, 6>) == 2, "");
+
+    using K = sg14::packed_key<20, 8, 4>;
+    K k(12345, 200, 9);
+    EXPECT_TRUE(k.index() == 12345);
+    EXPECT_TRUE(k.generation() == 200);
+    EXPECT_TRUE(k.tag() == 9);
+    k.set_tag(15);
+    k.set_generation(201);
+    EXPECT_TRUE(k == K(12345, 201, 15));
+    EXPECT_TRUE(K::from_value(k.value()) == k);
+#if __cplusplus >= 201703L
+    auto [idx, gen] = k;
+    EXPECT_TRUE(idx == 12345 && gen == 201);
+#endif
+
+    using slot_map_8 = sg14::slot_map<int, K>;
+    static_assert(std::is_same<slot_map_8::key_index_type, uint32_t>::value, "");
+    static_assert(std::is_same<slot_map_8::key_generation_type, uint8_t>::value, "");
+    BasicTests<slot_map_8>(42, 37);
+    BoundsCheckingTest<slot_map_8>();
+    FullContainerStressTest<slot_map_8>([]() { return 42; });
+    InsertEraseStressTest<slot_map_8>([i=3]() mutable { return ++i; });
+    EraseInLoopTest<slot_map_8>();
+    EraseRangeTest<slot_map_8>();
+    PartitionTest<slot_map_8>();
+    SortTest<slot_map_8>();
+    ReserveTest<slot_map_8>();
+    ReusePolicyTest<slot_map_8>();
+    ShrinkSlotsTest<slot_map_8>();
+    VerifyCapacityExists<slot_map_8>(true);
+    GenerationsDontSkipTest<slot_map_8>();
+    IndexesAreUsedEvenlyTest<slot_map_8>();
+    BatchInsertEraseTest<slot_map_8>();
+    FindManyTest<slot_map_8>();
+
+    // The generation wraps around within its bits, and lookups ignore the tag.
+    sg14::slot_map<int, sg14::packed_key<8, 2, 6>> sm;
+    auto k0 = sm.insert(1);
+    auto k1 = k0;
+    for (int i = 1; i <= 4; ++i) {
+        sm.erase(k1);
+        k1 = sm.insert(i);
+        EXPECT_TRUE(k1.index() == k0.index());
+        EXPECT_TRUE(k1.generation() == i % 4);
+    }
+    EXPECT_TRUE(k1 == k0);
+    k1.set_tag(63);
+    EXPECT_TRUE(sm.at(k1) == 4);
+}
+
+TEST(slot_map, PackedKeyOverflow)
+{
+    // A 4-bit index can name 15 slots, and 15 itself marks an empty free list.
+    using SM = sg14::slot_map<int, sg14::packed_key<4, 4>>;
+    SM sm;
+    std::vector<SM::key_type> keys;
+    for (int i = 0; i < 15; ++i) {
+        keys.push_back(sm.insert(i));
+    }
+    ASSERT_THROW(sm.insert(15), std::length_error);
+    EXPECT_TRUE(sm.size() == 15);
+    EXPECT_TRUE(sm.slot_count() == 15);
+    for (int i = 0; i < 15; ++i) {
+        EXPECT_TRUE(sm.at(keys[i]) == i);
+    }
+
+    // Once a slot is free, it can be reused.
+    sm.erase(keys[3]);
+    keys[3] = sm.insert(3);
+    EXPECT_TRUE(sm.at(keys[3]) == 3);
+    EXPECT_TRUE(sm.slot_count() == 15);
+
+    // The batch insertions throw before inserting anything.
+    sm.erase(keys[7]);
+    sm.erase(keys[8]);
+    ASSERT_THROW(sm.emplace_n(3, keys.begin(), 42), std::length_error);
+    int a[] = {1, 2, 3};
+    ASSERT_THROW(sm.insert(a, a + 3, keys.begin()), std::length_error);
+    EXPECT_TRUE(sm.size() == 13);
+    sm.emplace_n(2, keys.begin() + 7, 42);
+    EXPECT_TRUE(sm.size() == 15);
+
+    SM sm2;
+    ASSERT_THROW(sm2.reserve_slots(16), std::length_error);
+    EXPECT_TRUE(sm2.slot_count() == 0);
+    sm2.reserve_slots(15);
+    EXPECT_TRUE(sm2.slot_count() == 15);
+    for (int i = 0; i < 15; ++i) {
+        sm2.insert(i);
+    }
+    ASSERT_THROW(sm2.insert(15), std::length_error);
+}
+
+TEST(slot_map, EmplaceN)
+{
+    sg14::slot_map<int> sm = {1, 2, 3};
+    std::vector<sg14::slot_map<int>::key_type> keys(5);
+    auto it = sm.emplace_n(5, keys.begin(), 42);
+    EXPECT_TRUE(it == keys.end());
+    EXPECT_TRUE(sm.size() == 8);
+    for (auto&& k : keys) {
+        EXPECT_TRUE(sm.at(k) == 42);
+    }
+#if __cpp_lib_span >= 202002L
+    EXPECT_TRUE(sm.erase(std::span<const sg14::slot_map<int>::key_type>(keys.data(), 3)) == 3);
+    EXPECT_TRUE(sm.size() == 5);
+#endif
+}
+
+TEST(slot_map, FindManyLarge)
+{
+    // Big enough that find_many prefetches.
+    sg14::slot_map<int> sm;
+    std::vector<sg14::slot_map<int>::key_type> keys;
+    sm.emplace_n(200000, std::back_inserter(keys), 1);
+    sm.erase_keys(keys.begin(), keys.begin() + 1000);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937());
+    std::vector<sg14::slot_map<int>::iterator> its(keys.size());
+    sm.find_many(keys.begin(), keys.end(), its.begin());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_TRUE(its[i] == sm.find(keys[i]));
+    }
+    EXPECT_TRUE(std::count(its.begin(), its.end(), sm.end()) == 1000);
+}
+
+TEST(slot_map, SortLarge)
+{
+    sg14::slot_map<std::string> sm;
+    std::vector<sg14::slot_map<std::string>::key_type> keys;
+    std::mt19937 g;
+    for (int i = 0; i < 20000; ++i) {
+        keys.push_back(sm.insert(std::to_string(g() % 100000)));
+    }
+    sm.erase_keys(keys.begin(), keys.begin() + 5000);
+    auto expected = std::vector<std::string>(sm.begin(), sm.end());
+    sm.sort();
+    std::sort(expected.begin(), expected.end());
+    EXPECT_TRUE(std::equal(sm.begin(), sm.end(), expected.begin(), expected.end()));
+    for (size_t i = 5000; i < keys.size(); ++i) {
+        EXPECT_TRUE(sm.find(keys[i]) != sm.end());
+    }
+    auto values = std::vector<std::string>(sm.begin(), sm.end());
+    auto perm = std::vector<size_t>(sm.size());
+    std::iota(perm.begin(), perm.end(), size_t(0));
+    std::shuffle(perm.begin(), perm.end(), g);
+    auto key_of = [&](const std::string *p) {
+        for (size_t i = 5000; i < keys.size(); ++i) {
+            if (&*sm.find(keys[i]) == p) return keys[i];
+        }
+        return keys[0];
+    };
+    auto k7 = key_of(&*(sm.begin() + perm[7]));
+    sm.apply_permutation(perm.begin(), perm.end());
+    for (size_t i = 0; i < perm.size(); ++i) {
+        EXPECT_TRUE(*(sm.begin() + i) == values[perm[i]]);
+    }
+    EXPECT_TRUE(sm.find(k7) == sm.begin() + 7);
 }
 
 #if __cpp_concepts >= 202002
@@ -704,6 +1171,7 @@ concept SlotMapContainer =
 static_assert(SlotMapContainer<std::vector>);
 static_assert(SlotMapContainer<std::deque>);
 static_assert(SlotMapContainer<std::list>);
+static_assert(SlotMapContainer<sg14::chunked_vector>);
 static_assert(!SlotMapContainer<std::forward_list>);
 static_assert(!SlotMapContainer<std::pair>);
 #endif // __cpp_concepts >= 202002